@@ -0,0 +1,370 @@
+/*
+ * Cycle counts of the hot paths on the ATmega328 (env:nanoatmega328_cycles).
+ * Runs in simavr through tools/avr_cycles.py, or on a Nano at 115200 baud.
+ * Timer1 counts every CPU cycle; Timer0 (millis) and the UART interrupts
+ * are quiet while measuring, and the cost of reading the counter and of
+ * its overflow interrupt is calibrated away, so the counts are exact for
+ * the given inputs. One line per measurement:
+ *   CYCLES <name> <calls> <min> <mean> <max>
+ * then DONE. Nothing goes on the I2C bus: the SSD1306 framebuffer is
+ * drawn but never sent, and the sensor readings come from tables.
+ */
+
+#include <Arduino.h>
+#include <Adafruit_SSD1306.h>
+#include <avr/sleep.h>
+
+#include "class_descriptor.h"
+#include "color_match.h"
+#include "page_renderer.h"
+#include "rle_decoder.h"
+#include "sample_pipeline.h"
+#include "ssd1306_paged.h"
+#include "ita_string.h"
+
+namespace raw {
+#include "bitmap.h"
+}
+#include "bitmap_rle.h"
+#include "class_table.h"
+
+// Text size 2 of the paged SSD1306, 40x40 icons
+#define CYCLES_TEXT_WIDTH(chars) PAGE_TEXT_WIDTH(chars, 2)
+#define BITMAP_SIZE 40
+
+static const ClassDescriptor class_descriptors[COLOR_CLASS_COUNT + 1] PROGMEM =
+    CLASS_DESCRIPTOR_TABLE(CYCLES_TEXT_WIDTH);
+
+#define CYCLE_CALIBRATION 1000000UL    // cycles of the reference delay, ~15 counter wraps
+
+// Timer1 overflows, the high word of the cycle count
+static volatile uint16_t cycle_wraps;
+static uint16_t cycle_base;            // two cycleNow() back to back
+static uint16_t cycle_isr;             // one overflow interrupt
+
+volatile uint32_t cycle_sink;
+
+ISR(TIMER1_OVF_vect)
+{
+  cycle_wraps++;
+}
+
+static void cycleCounterBegin()
+{
+  TIMSK0 = 0;                          // millis() stops: no Timer0 interrupt in the counts
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);                  // F_CPU, no prescaler
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  TIMSK1 = _BV(TOIE1);
+}
+
+// Not inlined: the measured code cannot be moved across it
+static __attribute__((noinline)) uint32_t cycleNow()
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t low = TCNT1;
+  uint16_t high = cycle_wraps;
+  if ((TIFR1 & _BV(TOV1)) && low < 0x8000) {
+    high++;                            // wrapped, interrupt not served yet
+  }
+  SREG = sreg;
+  return ((uint32_t)high << 16) | low;
+}
+
+static uint32_t cyclesBetween(uint32_t start, uint32_t end)
+{
+  uint32_t wraps = (end >> 16) - (start >> 16);
+  return end - start - cycle_base - wraps * cycle_isr;
+}
+
+static void cycleCalibrate()
+{
+  uint32_t a = cycleNow();
+  uint32_t b = cycleNow();
+  cycle_base = (uint16_t)(b - a);
+  a = cycleNow();
+  __builtin_avr_delay_cycles(CYCLE_CALIBRATION);
+  b = cycleNow();
+  uint32_t wraps = (b >> 16) - (a >> 16);
+  uint32_t extra = b - a - cycle_base - CYCLE_CALIBRATION;
+  cycle_isr = (uint16_t)(extra / wraps);
+  Serial.print(F("CALIBRATION base "));
+  Serial.print(cycle_base);
+  Serial.print(F(" overflow "));
+  Serial.print(cycle_isr);
+  Serial.print(F(" remainder "));
+  Serial.println(extra % wraps);     // 0 when every wrap costs the same
+  Serial.flush();
+}
+
+struct CycleStats {
+  uint16_t calls;
+  uint32_t min, max, total;
+};
+
+static void statsReset(CycleStats* stats)
+{
+  stats->calls = 0;
+  stats->min = 0xFFFFFFFF;
+  stats->max = 0;
+  stats->total = 0;
+}
+
+static void statsAdd(CycleStats* stats, uint32_t cycles)
+{
+  stats->calls++;
+  stats->total += cycles;
+  if (cycles < stats->min) {
+    stats->min = cycles;
+  }
+  if (cycles > stats->max) {
+    stats->max = cycles;
+  }
+}
+
+// The UART is idle again before the next measurement starts
+static void statsPrint(const __FlashStringHelper* name, const CycleStats* stats)
+{
+  Serial.print(F("CYCLES "));
+  Serial.print(name);
+  Serial.print(' ');
+  Serial.print(stats->calls);
+  Serial.print(' ');
+  Serial.print(stats->min);
+  Serial.print(' ');
+  Serial.print((stats->total + stats->calls / 2) / stats->calls);
+  Serial.print(' ');
+  Serial.println(stats->max);
+  Serial.flush();
+}
+
+#define MEASURE(stats, code) do { \
+    uint32_t cycleStart = cycleNow(); \
+    code; \
+    statsAdd(&(stats), cyclesBetween(cycleStart, cycleNow())); \
+  } while (0)
+
+// SSD1306 with its framebuffer and without begin(): drawn, never sent
+class BenchSsd1306 : public Adafruit_SSD1306 {
+public:
+  BenchSsd1306() : Adafruit_SSD1306(128, 64, &Wire, -1) {
+    buffer = frame_;
+  }
+private:
+  uint8_t frame_[128 * 64 / 8];
+};
+
+static BenchSsd1306 display;
+
+// What the firmware did before tcs34725RawToRGB(): getRGB() then (uint8_t)
+static RGBColor rawToRGBFloat(uint16_t r, uint16_t g, uint16_t b, uint16_t c)
+{
+  RGBColor color;
+  if (c == 0) {
+    color.r = color.g = color.b = 0;
+    return color;
+  }
+  uint32_t sum = c;
+  color.r = (uint8_t)((float)r / sum * 255.0);
+  color.g = (uint8_t)((float)g / sum * 255.0);
+  color.b = (uint8_t)((float)b / sum * 255.0);
+  return color;
+}
+
+// Raw TCS34725 channels of a surface: clear from dark to bright
+static void rawSample(uint8_t i, uint16_t* r, uint16_t* g, uint16_t* b, uint16_t* c)
+{
+  *c = 300 + i * 157;
+  *r = (uint16_t)((uint32_t)*c * (40 + (i * 37) % 160) / 256);
+  *g = (uint16_t)((uint32_t)*c * (30 + (i * 53) % 150) / 256);
+  *b = (uint16_t)((uint32_t)*c * (20 + (i * 71) % 140) / 256);
+}
+
+// 5x5x5 grid of the RGB cube
+static RGBColor gridColor(uint8_t i)
+{
+  static const uint8_t levels[5] = {0, 64, 128, 191, 255};
+  RGBColor color = {levels[i % 5], levels[(i / 5) % 5], levels[i / 25]};
+  return color;
+}
+
+#define GRID_COLORS 125
+#define RAW_SAMPLES 64
+
+// Icon drawn span by span, as drawRleBitmap() in main.cpp
+static void drawRle(int x, int y, const unsigned char* asset)
+{
+  RleDecoder rle;
+  rleBegin(&rle, asset);
+  uint8_t value;
+  uint8_t length;
+  while ((length = rlePeek(&rle, &value)) != 0) {
+    if (value) {
+      display.drawFastHLine(x + rle.x, y + rle.y, length, WHITE);
+    }
+    rleConsume(&rle, length);
+  }
+}
+
+static const unsigned char* const raw_icons[] = {
+  raw::epd_bitmap_gray, raw::epd_bitmap_red, raw::epd_bitmap_yellow, raw::epd_bitmap_green,
+  raw::epd_bitmap_blue, raw::epd_bitmap_brown, raw::epd_bitmap_orange, raw::epd_bitmap_purple,
+  raw::epd_bitmap_pink, raw::epd_bitmap_azure,
+};
+#define RAW_ICON_COUNT (sizeof(raw_icons) / sizeof(raw_icons[0]))
+
+// Everything loop() computes for one reading with the Nano build
+// (TCS34725, STABLE_DETECTION, paged SSD1306): conversion, filter and
+// match, class lookup and the eight pages composed; I2C and serial aside
+static void loopIteration(SamplePipeline* pipeline, uint8_t i)
+{
+  uint16_t r, g, b, c;
+  rawSample(i, &r, &g, &b, &c);
+  RGBColor color = tcs34725RawToRGB(r, g, b, c);
+  PipelineResult result;
+  samplePipelineRun(pipeline, color, &result);
+  ClassDescriptor descriptor;
+  classDescriptorRead(class_descriptors, result.colorClass, &descriptor);
+  char name[CLASS_NAME_SIZE];
+  classNameCopy(&descriptor, name, sizeof(name));
+  PageFrame frame;
+  uint8_t textFirst, textLast;
+  uint8_t size = descriptor.bitmap ? BITMAP_SIZE : 0;
+  pageLayout(&frame, descriptor.bitmap, size, size, name, ssd1306_paged_font, descriptor.textWidth, &textFirst,
+             &textLast);
+  RleDecoder rle;
+  if (descriptor.bitmap) {
+    rleBegin(&rle, descriptor.bitmap);
+    frame.rle = &rle;
+  }
+  uint8_t page[PAGE_SCREEN_WIDTH];
+  for (uint8_t p = 0; p < PAGE_COUNT; p++) {
+    pageRender(&frame, p, page);
+  }
+  cycle_sink += page[0] + textFirst + textLast;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  cycleCounterBegin();
+  cycleCalibrate();
+  CycleStats stats;
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < GRID_COLORS; i++) {
+    RGBColor color = gridColor(i);
+    uint32_t distance;
+    MEASURE(stats, cycle_sink += bestMatchRGB(color, &distance));
+  }
+  statsPrint(F("bestMatchRGB"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < RAW_SAMPLES; i++) {
+    uint16_t r, g, b, c;
+    rawSample(i, &r, &g, &b, &c);
+    MEASURE(stats, cycle_sink += tcs34725RawToRGB(r, g, b, c).r);
+  }
+  statsPrint(F("tcs34725RawToRGB"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < RAW_SAMPLES; i++) {
+    uint16_t r, g, b, c;
+    rawSample(i, &r, &g, &b, &c);
+    MEASURE(stats, cycle_sink += rawToRGBFloat(r, g, b, c).r);
+  }
+  statsPrint(F("getRGB_float_cast"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < RAW_SAMPLES; i++) {
+    int raw = 20 + i * 3;
+    MEASURE(stats, cycle_sink += tcs3200RawToChannel(raw, 25, 200));
+  }
+  statsPrint(F("tcs3200RawToChannel"), &stats);
+
+  SamplePipeline pipeline;
+  samplePipelineReset(&pipeline, PIPELINE_STABLE);
+  statsReset(&stats);
+  for (uint8_t i = 0; i < GRID_COLORS; i++) {
+    PipelineResult result;
+    MEASURE(stats, samplePipelineRun(&pipeline, gridColor(i), &result));
+    cycle_sink += result.colorClass;
+  }
+  statsPrint(F("samplePipelineRun_stable"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < RAW_ICON_COUNT; i++) {
+    display.clearDisplay();
+    MEASURE(stats, display.drawBitmap((128 - BITMAP_SIZE) / 2, 0, raw_icons[i], BITMAP_SIZE, BITMAP_SIZE, WHITE));
+  }
+  statsPrint(F("ssd1306_drawBitmap_40x40"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT; i++) {
+    ClassDescriptor descriptor;
+    classDescriptorRead(class_descriptors, (ColorClass)i, &descriptor);
+    display.clearDisplay();
+    MEASURE(stats, drawRle((128 - BITMAP_SIZE) / 2, 0, descriptor.bitmap));
+  }
+  statsPrint(F("ssd1306_drawRle_40x40"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT + 1; i++) {
+    ClassDescriptor descriptor;
+    classDescriptorRead(class_descriptors, i < COLOR_CLASS_COUNT ? (ColorClass)i : COL_UNDEFINED, &descriptor);
+    char name[CLASS_NAME_SIZE];
+    classNameCopy(&descriptor, name, sizeof(name));
+    display.setTextSize(2);
+    display.setTextColor(WHITE);
+    display.setCursor(0, 44);
+    MEASURE(stats, display.print(name));
+  }
+  statsPrint(F("ssd1306_print_size2"), &stats);
+
+  statsReset(&stats);
+  MEASURE(stats, display.clearDisplay());
+  statsPrint(F("ssd1306_clearDisplay"), &stats);
+
+  statsReset(&stats);
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT + 1; i++) {
+    ClassDescriptor descriptor;
+    classDescriptorRead(class_descriptors, i < COLOR_CLASS_COUNT ? (ColorClass)i : COL_UNDEFINED, &descriptor);
+    char name[CLASS_NAME_SIZE];
+    classNameCopy(&descriptor, name, sizeof(name));
+    PageFrame frame;
+    uint8_t textFirst, textLast;
+    uint8_t size = descriptor.bitmap ? BITMAP_SIZE : 0;
+    pageLayout(&frame, descriptor.bitmap, size, size, name, ssd1306_paged_font, descriptor.textWidth, &textFirst,
+               &textLast);
+    RleDecoder rle;
+    if (descriptor.bitmap) {
+      rleBegin(&rle, descriptor.bitmap);
+      frame.rle = &rle;
+    }
+    uint8_t page[PAGE_SCREEN_WIDTH];
+    MEASURE(stats, for (uint8_t p = 0; p < PAGE_COUNT; p++) { pageRender(&frame, p, page); });
+    cycle_sink += page[0];
+  }
+  statsPrint(F("pageRender_frame"), &stats);
+
+  samplePipelineReset(&pipeline, PIPELINE_STABLE);
+  statsReset(&stats);
+  for (uint8_t i = 0; i < RAW_SAMPLES; i++) {
+    MEASURE(stats, loopIteration(&pipeline, i));
+  }
+  statsPrint(F("loop_iteration_cpu"), &stats);
+
+  Serial.println(F("DONE"));
+  Serial.flush();
+  // simavr stops on a sleep with interrupts off
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  cli();
+  sleep_cpu();
+}
+
+void loop()
+{
+}
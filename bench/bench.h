@@ -0,0 +1,85 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/*
+	Host benchmark helpers (env:native).
+	Each bench_*.cpp registers one run function in bench_main.cpp.
+*/
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "color_match.h"
+
+struct BenchOptions {
+  uint32_t samples;         // synthetic samples per run
+  const char* recordedPath; // optional CSV "r,g,b" of recorded sensor samples
+  const char* tracePath;    // optional raw sensor trace for the replay (bench_replay.cpp)
+};
+
+class BenchTimer {
+public:
+  BenchTimer() : start_(std::chrono::steady_clock::now()) {}
+  double elapsedNs() const {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+  }
+private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Small deterministic PRNG so every run sees the same samples
+class BenchRng {
+public:
+  explicit BenchRng(uint32_t seed) : state_(seed ? seed : 0x9E3779B9u) {}
+  uint32_t next() {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+  // Roughly gaussian, sum of four uniforms in [-range, range]
+  int noise(int range) {
+    int sum = 0;
+    for (int i = 0; i < 4; i++) {
+      sum += (int)(next() % (2 * range + 1)) - range;
+    }
+    return sum / 2;
+  }
+private:
+  uint32_t state_;
+};
+
+// Keeps the optimizer from dropping the measured work
+extern volatile uint32_t bench_sink;
+
+void benchReport(const char* name, size_t samples, double ns);
+
+std::vector<RGBColor> benchUniformSamples(size_t count, uint32_t seed);
+std::vector<RGBColor> benchJitteredSamples(const ColoReference* table, size_t tableCount, size_t count, uint32_t seed);
+bool benchLoadRecorded(const char* path, std::vector<RGBColor>& out);
+
+// Each returns false when a correctness check fails
+bool benchClassifier(const BenchOptions& options);
+bool benchLut(const BenchOptions& options);
+bool benchPalette(const BenchOptions& options);
+bool benchLab(const BenchOptions& options);
+bool benchRanging(const BenchOptions& options);
+bool benchConversion(const BenchOptions& options);
+bool benchFilter(const BenchOptions& options);
+bool benchRender(const BenchOptions& options);
+bool benchTelemetry(const BenchOptions& options);
+bool benchCalibration(const BenchOptions& options);
+bool benchConfig(const BenchOptions& options);
+bool benchBoot(const BenchOptions& options);
+bool benchMemory(const BenchOptions& options);
+bool benchLoop(const BenchOptions& options);
+bool benchSweep(const BenchOptions& options);
+bool benchPower(const BenchOptions& options);
+bool benchReplay(const BenchOptions& options);
+bool benchBurst(const BenchOptions& options);
+bool benchPipeline(const BenchOptions& options);
+bool benchDrivers(const BenchOptions& options);
+
+#endif
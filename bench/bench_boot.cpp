@@ -0,0 +1,51 @@
+/*
+ * Boot profile: a stage is stamped only once and the profile completes
+ * with the last one, boot frame round trip with every single bit error
+ * caught by the CRC.
+ */
+
+#include "bench.h"
+#include "boot_profile.h"
+#include "telemetry.h"
+
+bool benchBoot(const BenchOptions& options)
+{
+  (void)options;
+  printf("== boot profile ==\n");
+  BootProfile profile;
+  bootProfileReset(&profile);
+
+  // Stages out of order and repeated, as loop() calls them on every sample
+  static const BootStage order[] = {BOOT_SETUP, BOOT_CONFIG, BOOT_SENSOR, BOOT_DISPLAY, BOOT_FIRST_SAMPLE,
+                                    BOOT_FIRST_SAMPLE, BOOT_SENSOR, BOOT_FIRST_SAMPLE, BOOT_FIRST_RESULT,
+                                    BOOT_FIRST_RESULT};
+  uint32_t completions = 0;
+  uint32_t completedAt = 0;
+  for (uint32_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+    if (bootProfileMark(&profile, order[i], 1000 * (i + 1))) {
+      completions++;
+      completedAt = i;
+    }
+  }
+  bool marksOk = completions == 1 && completedAt == 8 && bootProfileComplete(&profile)
+              && profile.us[BOOT_SENSOR] == 3000 && profile.us[BOOT_FIRST_SAMPLE] == 5000;
+
+  uint8_t frame[TELEMETRY_BOOT_FRAME_SIZE];
+  telemetryEncodeBoot(&profile, frame);
+  BootProfile back;
+  bool roundTrip = telemetryDecodeBoot(frame, &back) && bootProfileComplete(&back);
+  for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    roundTrip &= back.us[i] == profile.us[i];
+  }
+  uint32_t accepted = 0;
+  for (uint16_t bit = 0; bit < TELEMETRY_BOOT_FRAME_SIZE * 8; bit++) {
+    frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    if (telemetryDecodeBoot(frame, &back)) {
+      accepted++;
+    }
+    frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+  }
+  printf("stages stamped once %s, boot frame %u bytes, round trip %s, single bit errors accepted: %u\n",
+         marksOk ? "ok" : "FAILED", (unsigned)TELEMETRY_BOOT_FRAME_SIZE, roundTrip ? "ok" : "FAILED", accepted);
+  return marksOk && roundTrip && accepted == 0;
+}
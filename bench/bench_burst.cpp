@@ -0,0 +1,181 @@
+/*
+ * Burst sampling: bestMatchRGBScore() checked against bestMatchRGB(), the
+ * robust mean against a spike, and the accuracy and readings per answer of
+ * an adaptive burst compared with one reading and with a fixed burst.
+ */
+
+#include "bench.h"
+#include "color_burst.h"
+
+static uint8_t clampChannel(int v)
+{
+  return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+static uint32_t distance2(RGBColor x, RGBColor y)
+{
+  int dr = x.r - y.r, dg = x.g - y.g, db = x.b - y.b;
+  return (uint32_t)(dr * dr + dg * dg + db * db);
+}
+
+// Same class and distance as bestMatchRGB() on every sample
+static bool checkScore(const std::vector<RGBColor>& samples, const char* name)
+{
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint32_t minDist;
+#ifdef COLOR_MATCH_LUT
+    // The cube has no distances: compare with the scan it was built from
+    ColorClass expected = bestMatchRGBTable(color_reference, color_reference_count, samples[i], &minDist);
+#else
+    ColorClass expected = bestMatchRGB(samples[i], &minDist);
+#endif
+    MatchScore score;
+    bestMatchRGBScore(samples[i], &score);
+    if (score.best != expected || score.bestDist != minDist || score.second == score.best) {
+      printf("FAILED: %s sample %u,%u,%u: %d/%u, bestMatchRGB() %d/%u\n", name, samples[i].r, samples[i].g,
+             samples[i].b, score.best, score.bestDist, expected, minDist);
+      return false;
+    }
+  }
+  return true;
+}
+
+struct BurstRun {
+  uint32_t answers;
+  uint32_t correct;
+  uint32_t readings;
+};
+
+// Reading of a surface: sensor noise and now and then a spike on one channel
+static RGBColor noisyReading(RGBColor c, BenchRng& rng, int noise)
+{
+  RGBColor s = {clampChannel(c.r + rng.noise(noise)), clampChannel(c.g + rng.noise(noise)),
+                clampChannel(c.b + rng.noise(noise))};
+  if (rng.next() % 12 == 0) {
+    uint8_t* channel = rng.next() & 1 ? &s.r : &s.g;
+    *channel = clampChannel(*channel + 90);
+  }
+  return s;
+}
+
+bool benchBurst(const BenchOptions& options)
+{
+  printf("== burst sampling ==\n");
+  bool ok = true;
+
+  // The score must pick what bestMatchRGB() picks, with THRESHOLD and with per-class thresholds
+  std::vector<RGBColor> uniform = benchUniformSamples(options.samples / 20, 5);
+  std::vector<RGBColor> jittered = benchJitteredSamples(color_reference, color_reference_count, options.samples / 20, 6);
+  bool same = checkScore(uniform, "uniform") && checkScore(jittered, "jittered");
+  uint16_t thresholds[COLOR_CLASS_COUNT];
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    thresholds[c] = (uint16_t)(200 + 150 * c);
+  }
+  if (colorMatchSetTable(color_reference, color_reference_count, thresholds)) {
+    same &= checkScore(uniform, "uniform, per-class thresholds") && checkScore(jittered, "jittered, per-class thresholds");
+    colorMatchSetTable(nullptr, 0, nullptr);
+  }
+  printf("bestMatchRGBScore() same class and distance as bestMatchRGB(): %s\n", same ? "ok" : "FAILED");
+  ok &= same;
+
+  BenchTimer scoreTimer;
+  for (size_t i = 0; i < jittered.size(); i++) {
+    MatchScore score;
+    bestMatchRGBScore(jittered[i], &score);
+    bench_sink += score.confidence;
+  }
+  benchReport("bestMatchRGBScore", jittered.size(), scoreTimer.elapsedNs());
+
+  // Exactly on a reference: nothing is closer. Half way between references
+  // of two classes, when no other one is nearer: a coin toss
+  uint32_t onReference = 0, halfWay = 0, unsure = 0;
+  for (size_t i = 0; i < color_reference_count; i++) {
+    MatchScore score;
+    bestMatchRGBScore(color_reference[i].reference_color, &score);
+    onReference += score.confidence == 255;
+    for (size_t j = 0; j < color_reference_count; j++) {
+      const ColoReference& a = color_reference[i];
+      const ColoReference& b = color_reference[j];
+      RGBColor mid = {(uint8_t)((a.reference_color.r + b.reference_color.r + 1) / 2),
+                      (uint8_t)((a.reference_color.g + b.reference_color.g + 1) / 2),
+                      (uint8_t)((a.reference_color.b + b.reference_color.b + 1) / 2)};
+      bestMatchRGBScore(mid, &score);
+      uint32_t toA = distance2(mid, a.reference_color);
+      uint32_t toB = distance2(mid, b.reference_color);
+      bool between = (score.bestDist == toA && score.secondDist == toB) || (score.bestDist == toB && score.secondDist == toA);
+      if (a.color_class == b.color_class || score.best == COL_UNDEFINED || !between) {
+        continue;
+      }
+      halfWay++;
+      unsure += score.confidence < COLOR_BURST_CONFIDENT;
+    }
+  }
+  printf("confidence 255 on %u of %zu references, below %u half way between %u of %u pairs of classes\n",
+         onReference, color_reference_count, COLOR_BURST_CONFIDENT, unsure, halfWay);
+  ok &= onReference == color_reference_count && unsure == halfWay;
+
+  // A spike moves the plain mean, not the robust one
+  ColorBurst burst;
+  colorBurstReset(&burst);
+  RGBColor surface = {120, 60, 40};
+  for (uint8_t i = 0; i < 7; i++) {
+    RGBColor s = surface;
+    s.r = (uint8_t)(s.r + (i % 3) - 1);
+    if (i == 4) {
+      s.g = 250;
+    }
+    burst.samples[burst.count++] = s;
+  }
+  uint8_t kept;
+  RGBColor robust = colorBurstRobustMean(&burst, &kept);
+  uint32_t plainG = 0;
+  for (uint8_t i = 0; i < burst.count; i++) {
+    plainG += burst.samples[i].g;
+  }
+  bool spikeOk = kept == 6 && robust.g == surface.g && robust.r >= surface.r - 1 && robust.r <= surface.r + 1;
+  printf("one spike in 7 readings: green %u robust, %u plain mean, %u kept: %s\n",
+         robust.g, plainG / burst.count, kept, spikeOk ? "ok" : "FAILED");
+  ok &= spikeOk;
+
+  // Every reference surface read many times: one reading, a fixed burst of
+  // COLOR_BURST_MAX, and the adaptive burst
+  BurstRun single = {0, 0, 0}, fixed = {0, 0, 0}, adaptive = {0, 0, 0};
+  const uint32_t answersPerSurface = 200;
+  BenchTimer burstTimer;
+  for (size_t i = 0; i < color_reference_count; i++) {
+    const ColoReference& ref = color_reference[i];
+    BenchRng rng(100 + (uint32_t)i);
+    for (uint32_t n = 0; n < answersPerSurface; n++) {
+      single.correct += bestMatchRGB(noisyReading(ref.reference_color, rng, 10), nullptr) == ref.color_class;
+      single.answers++;
+      single.readings++;
+
+      colorBurstReset(&burst);
+      for (uint8_t k = 0; k < COLOR_BURST_MAX; k++) {
+        burst.samples[burst.count++] = noisyReading(ref.reference_color, rng, 10);
+      }
+      fixed.correct += bestMatchRGB(colorBurstRobustMean(&burst, nullptr), nullptr) == ref.color_class;
+      fixed.answers++;
+      fixed.readings += COLOR_BURST_MAX;
+
+      colorBurstReset(&burst);
+      MatchScore score;
+      while (!colorBurstAdd(&burst, noisyReading(ref.reference_color, rng, 10), &score)) {
+      }
+      adaptive.correct += score.best == ref.color_class;
+      adaptive.answers++;
+      adaptive.readings += burst.used;
+    }
+  }
+  double burstNs = burstTimer.elapsedNs();
+  const BurstRun* runs[] = {&single, &fixed, &adaptive};
+  const char* names[] = {"one reading", "fixed burst of 9", "adaptive burst"};
+  for (int r = 0; r < 3; r++) {
+    printf("%-18s %5.1f%% correct, %4.2f readings per answer\n", names[r],
+           100.0 * runs[r]->correct / runs[r]->answers, (double)runs[r]->readings / runs[r]->answers);
+  }
+  printf("all three on %u answers: %.0f ns per answer\n", single.answers, burstNs / single.answers);
+  // Better than one reading, with far fewer readings than the fixed burst
+  ok &= adaptive.correct > single.correct && adaptive.readings * 2 < fixed.readings;
+  return ok;
+}
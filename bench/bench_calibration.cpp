@@ -0,0 +1,68 @@
+/*
+ * Per-class thresholds (COLOR_MATCH_CALIBRATED): with every class at
+ * THRESHOLD the result must be the one of bestMatchRGBTable(), a class at
+ * 0 only on an exact match. Then the cost of the threshold lookup.
+ */
+
+#include "bench.h"
+
+static uint32_t mismatches(const ColoReference* table, size_t count, const uint16_t* thresholds,
+                           const std::vector<RGBColor>& samples)
+{
+  uint32_t differ = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint32_t distA, distB;
+    ColorClass a = bestMatchRGBTable(table, count, samples[i], &distA);
+    ColorClass b = bestMatchRGBTableThresholds(table, count, thresholds, samples[i], &distB);
+    if (a != b || distA != distB) {
+      differ++;
+    }
+  }
+  return differ;
+}
+
+static void runThresholds(const char* name, const ColoReference* table, size_t count, const uint16_t* thresholds,
+                          const std::vector<RGBColor>& samples)
+{
+  uint32_t checksum = 0;
+  BenchTimer timer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint32_t minDist;
+    checksum += (uint32_t)bestMatchRGBTableThresholds(table, count, thresholds, samples[i], &minDist) + minDist;
+  }
+  double ns = timer.elapsedNs();
+  bench_sink += checksum;
+  benchReport(name, samples.size(), ns);
+}
+
+bool benchCalibration(const BenchOptions& options)
+{
+  printf("== classifier (per-class thresholds) ==\n");
+  std::vector<RGBColor> uniform = benchUniformSamples(options.samples, 1);
+  std::vector<RGBColor> nanoJitter = benchJitteredSamples(color_reference_nano, color_reference_nano_count, options.samples, 2);
+
+  uint16_t flat[COLOR_CLASS_COUNT];
+  for (int i = 0; i < COLOR_CLASS_COUNT; i++) {
+    flat[i] = THRESHOLD;
+  }
+  uint32_t differ = mismatches(color_reference_nano, color_reference_nano_count, flat, uniform)
+                  + mismatches(color_reference_nano, color_reference_nano_count, flat, nanoJitter);
+
+  uint16_t noRed[COLOR_CLASS_COUNT];
+  for (int i = 0; i < COLOR_CLASS_COUNT; i++) {
+    noRed[i] = THRESHOLD;
+  }
+  noRed[COL_RED] = 0;
+  uint32_t red = 0;
+  for (size_t i = 0; i < nanoJitter.size(); i++) {
+    uint32_t dist;
+    if (bestMatchRGBTableThresholds(color_reference_nano, color_reference_nano_count, noRed, nanoJitter[i], &dist) == COL_RED && dist > 0) {
+      red++;
+    }
+  }
+  printf("flat thresholds: %u samples differ from THRESHOLD, RED matched %u times off its references at threshold 0\n", differ, red);
+
+  runThresholds("nano/thresholds/uniform", color_reference_nano, color_reference_nano_count, flat, uniform);
+  runThresholds("nano/thresholds/jittered", color_reference_nano, color_reference_nano_count, flat, nanoJitter);
+  return differ == 0 && red == 0;
+}
@@ -0,0 +1,48 @@
+/*
+ * bestMatchRGB() throughput on the Nano and ESP32-C3 reference tables
+ */
+
+#include "bench.h"
+
+static void runTable(const char* name, const ColoReference* table, size_t count, const std::vector<RGBColor>& samples)
+{
+  uint32_t checksum = 0;
+  BenchTimer timer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint32_t minDist;
+    checksum += (uint32_t)bestMatchRGBTable(table, count, samples[i], &minDist) + minDist;
+  }
+  double ns = timer.elapsedNs();
+  bench_sink += checksum;
+  benchReport(name, samples.size(), ns);
+}
+
+bool benchClassifier(const BenchOptions& options)
+{
+  printf("== classifier (linear scan) ==\n");
+  std::vector<RGBColor> uniform = benchUniformSamples(options.samples, 1);
+  std::vector<RGBColor> nanoJitter = benchJitteredSamples(color_reference_nano, color_reference_nano_count, options.samples, 2);
+  std::vector<RGBColor> espJitter = benchJitteredSamples(color_reference_esp32c3, color_reference_esp32c3_count, options.samples, 3);
+
+  runTable("nano/uniform", color_reference_nano, color_reference_nano_count, uniform);
+  runTable("nano/jittered", color_reference_nano, color_reference_nano_count, nanoJitter);
+  runTable("esp32c3/uniform", color_reference_esp32c3, color_reference_esp32c3_count, uniform);
+  runTable("esp32c3/jittered", color_reference_esp32c3, color_reference_esp32c3_count, espJitter);
+
+  if (options.recordedPath) {
+    std::vector<RGBColor> recorded;
+    if (!benchLoadRecorded(options.recordedPath, recorded) || recorded.empty()) {
+      printf("cannot read recorded samples from %s\n", options.recordedPath);
+      return false;
+    }
+    // Repeat the recording until it is as long as the synthetic runs
+    std::vector<RGBColor> looped;
+    looped.reserve(options.samples);
+    while (looped.size() < options.samples) {
+      looped.push_back(recorded[looped.size() % recorded.size()]);
+    }
+    runTable("nano/recorded", color_reference_nano, color_reference_nano_count, looped);
+    runTable("esp32c3/recorded", color_reference_esp32c3, color_reference_esp32c3_count, looped);
+  }
+  return true;
+}
@@ -0,0 +1,110 @@
+/*
+ * Per-unit configuration record: encode/decode round trip, every single
+ * bit error and a version change rejected, save/load through the file
+ * stand-in of the host build, gain choice on simulated white surfaces.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "device_config.h"
+#include "telemetry.h"
+
+static bool sameConfig(const DeviceConfig* a, const DeviceConfig* b)
+{
+  if (memcmp(a->tcs3200Min, b->tcs3200Min, sizeof(a->tcs3200Min)) != 0 ||
+      memcmp(a->tcs3200Max, b->tcs3200Max, sizeof(a->tcs3200Max)) != 0 ||
+      a->tcs34725Gain != b->tcs34725Gain || a->referenceCount != b->referenceCount ||
+      memcmp(a->thresholds, b->thresholds, sizeof(a->thresholds)) != 0) {
+    return false;
+  }
+  for (uint8_t i = 0; i < a->referenceCount; i++) {
+    const ColoReference& x = a->references[i];
+    const ColoReference& y = b->references[i];
+    if (x.reference_color.r != y.reference_color.r || x.reference_color.g != y.reference_color.g ||
+        x.reference_color.b != y.reference_color.b || x.color_class != y.color_class) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool benchConfig(const BenchOptions& options)
+{
+  (void)options;
+  printf("== device configuration ==\n");
+  bool ok = true;
+
+  DeviceConfig config;
+  deviceConfigDefaults(&config);
+  const int16_t white[3] = {31, 28, 22};
+  const int16_t black[3] = {310, 402, 288};
+  memcpy(config.tcs3200Min, white, sizeof(white));
+  memcpy(config.tcs3200Max, black, sizeof(black));
+  config.tcs34725Gain = 3;
+  config.referenceCount = DEVICE_CONFIG_MAX_REFERENCES < color_reference_nano_count
+                        ? DEVICE_CONFIG_MAX_REFERENCES : (uint8_t)color_reference_nano_count;
+  for (uint8_t i = 0; i < config.referenceCount; i++) {
+    config.references[i] = color_reference_nano[i];
+  }
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT; i++) {
+    config.thresholds[i] = (uint16_t)(100 * i + 50);
+  }
+
+  uint8_t record[DEVICE_CONFIG_RECORD_SIZE];
+  deviceConfigEncode(&config, record);
+  DeviceConfig back;
+  deviceConfigDefaults(&back);
+  bool roundTrip = deviceConfigDecode(record, &back) && sameConfig(&config, &back);
+
+  uint32_t accepted = 0;
+  for (uint16_t bit = 0; bit < DEVICE_CONFIG_RECORD_SIZE * 8; bit++) {
+    record[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    if (deviceConfigDecode(record, &back)) {
+      accepted++;
+    }
+    record[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+  }
+  // Another version with a valid CRC must not be read as this one
+  record[1] = DEVICE_CONFIG_VERSION + 1;
+  uint16_t crc = telemetryCrc16(record, DEVICE_CONFIG_RECORD_SIZE - 2);
+  record[DEVICE_CONFIG_RECORD_SIZE - 2] = (uint8_t)crc;
+  record[DEVICE_CONFIG_RECORD_SIZE - 1] = (uint8_t)(crc >> 8);
+  bool versionRejected = !deviceConfigDecode(record, &back);
+  printf("record %u bytes, round trip %s, single bit errors accepted: %u, other version %s\n",
+         (unsigned)DEVICE_CONFIG_RECORD_SIZE, roundTrip ? "ok" : "FAILED", accepted,
+         versionRejected ? "rejected" : "ACCEPTED");
+  ok &= roundTrip && accepted == 0 && versionRejected;
+
+  // File stand-in: nothing stored gives the defaults, then a save is loaded back
+  const char* path = "bench_device_config.bin";
+  remove(path);
+  deviceConfigSetPath(path);
+  DeviceConfig defaults;
+  deviceConfigDefaults(&defaults);
+  bool emptyOk = !deviceConfigLoad(&back) && sameConfig(&back, &defaults);
+  bool storedOk = deviceConfigSave(&config) && deviceConfigLoad(&back) && sameConfig(&back, &config);
+  remove(path);
+  printf("file storage: empty %s, save and load %s\n", emptyOk ? "ok" : "FAILED", storedOk ? "ok" : "FAILED");
+  ok &= emptyOk && storedOk;
+
+  // White surface clear counts at 1x..60x for 2.4 ms (full scale 1024)
+  static const struct {
+    uint16_t clear1x;
+    uint8_t gain;
+  } surfaces[] = {{5, 3}, {15, 2}, {40, 2}, {60, 1}, {300, 0}, {1024, 0}};
+  static const uint8_t factor[4] = {1, 4, 16, 60};
+  for (size_t i = 0; i < sizeof(surfaces) / sizeof(surfaces[0]); i++) {
+    uint16_t clearAtGain[4];
+    for (uint8_t g = 0; g < 4; g++) {
+      uint32_t c = (uint32_t)surfaces[i].clear1x * factor[g];
+      clearAtGain[g] = (uint16_t)(c > 1024 ? 1024 : c);
+    }
+    uint8_t gain = deviceConfigPickGain(clearAtGain, 1024);
+    printf("white at %4u counts (1x): gain %ux %s\n", surfaces[i].clear1x, factor[gain],
+           gain == surfaces[i].gain ? "ok" : "WRONG");
+    ok &= gain == surfaces[i].gain;
+  }
+  return ok;
+}
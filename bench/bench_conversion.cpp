@@ -0,0 +1,106 @@
+/*
+ * TCS34725 raw to RGB: fixed point tcs34725RawToRGB() against the float
+ * math of Adafruit_TCS34725::getRGB() followed by the (uint8_t) cast.
+ */
+
+#include "bench.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define BENCH_HAS_TSC
+#endif
+
+struct RawSample {
+  uint16_t r, g, b, c;
+};
+
+// What the firmware did before: getRGB() then (uint8_t)
+static RGBColor rawToRGBFloat(uint16_t r, uint16_t g, uint16_t b, uint16_t c)
+{
+  RGBColor color;
+  if (c == 0) {
+    color.r = color.g = color.b = 0;
+    return color;
+  }
+  uint32_t sum = c;
+  color.r = (uint8_t)((float)r / sum * 255.0);
+  color.g = (uint8_t)((float)g / sum * 255.0);
+  color.b = (uint8_t)((float)b / sum * 255.0);
+  return color;
+}
+
+static int channelError(uint8_t a, uint8_t b)
+{
+  return a > b ? a - b : b - a;
+}
+
+static std::vector<RawSample> rawSamples(size_t count, uint32_t seed)
+{
+  BenchRng rng(seed);
+  std::vector<RawSample> samples(count);
+  for (size_t i = 0; i < count; i++) {
+    // Clear from a few counts to full scale, channels below clear as on the real sensor
+    uint16_t c = (uint16_t)(1 + rng.next() % ((1u << (1 + rng.next() % 16)) - 1));
+    samples[i].c = c;
+    samples[i].r = (uint16_t)(rng.next() % c);
+    samples[i].g = (uint16_t)(rng.next() % c);
+    samples[i].b = (uint16_t)(rng.next() % c);
+  }
+  return samples;
+}
+
+template <typename F>
+static void timeConversion(const char* name, const std::vector<RawSample>& samples, F convert)
+{
+  uint32_t checksum = 0;
+#ifdef BENCH_HAS_TSC
+  uint64_t cycles = __rdtsc();
+#endif
+  BenchTimer timer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    RGBColor c = convert(samples[i].r, samples[i].g, samples[i].b, samples[i].c);
+    checksum += c.r + c.g + c.b;
+  }
+  double ns = timer.elapsedNs();
+  bench_sink += checksum;
+#ifdef BENCH_HAS_TSC
+  cycles = __rdtsc() - cycles;
+  printf("%-28s %8.2f ns %8.1f TSC cycles per sample\n", name, ns / samples.size(), (double)cycles / samples.size());
+#else
+  printf("%-28s %8.2f ns per sample\n", name, ns / samples.size());
+#endif
+}
+
+bool benchConversion(const BenchOptions& options)
+{
+  printf("== TCS34725 raw to RGB ==\n");
+  // Every channel value for a set of clear values, plus random samples
+  int worst = 0;
+  const uint16_t clears[] = {1, 2, 3, 7, 100, 255, 256, 1000, 1023, 1024, 4097, 10240, 43007, 65534, 65535};
+  for (size_t i = 0; i < sizeof(clears) / sizeof(clears[0]); i++) {
+    for (uint32_t v = 0; v < clears[i]; v++) {
+      RGBColor f = rawToRGBFloat((uint16_t)v, 0, 0, clears[i]);
+      RGBColor x = tcs34725RawToRGB((uint16_t)v, 0, 0, clears[i]);
+      int e = channelError(f.r, x.r);
+      worst = e > worst ? e : worst;
+    }
+  }
+  std::vector<RawSample> samples = rawSamples(options.samples, 7);
+  for (size_t i = 0; i < samples.size(); i++) {
+    const RawSample& s = samples[i];
+    RGBColor f = rawToRGBFloat(s.r, s.g, s.b, s.c);
+    RGBColor x = tcs34725RawToRGB(s.r, s.g, s.b, s.c);
+    int e = channelError(f.r, x.r);
+    e = channelError(f.g, x.g) > e ? channelError(f.g, x.g) : e;
+    e = channelError(f.b, x.b) > e ? channelError(f.b, x.b) : e;
+    worst = e > worst ? e : worst;
+  }
+  printf("max difference from the float path: %d\n", worst);
+
+  timeConversion("float (getRGB + cast)", samples, rawToRGBFloat);
+  timeConversion("fixed point reciprocal", samples, tcs34725RawToRGB);
+  if (worst > 1) {
+    printf("FAILED: fixed point conversion differs by more than 1\n");
+  }
+  return worst <= 1;
+}
@@ -0,0 +1,64 @@
+/*
+ * Driver policies (drivers.h): the mock sensor and display run through
+ * scanStep() must give what the pipeline gives when called by hand, and
+ * the static dispatch must cost no more than the direct calls.
+ */
+
+#include "bench.h"
+#include "drivers.h"
+
+typedef Sensor<MockSensor> BenchSensor;
+typedef Display<MockDisplay> BenchDisplay;
+
+bool benchDrivers(const BenchOptions& options)
+{
+  printf("== driver policies ==\n");
+  std::vector<RGBColor> samples = benchJitteredSamples(color_reference, color_reference_count, 4096, 21);
+  const uint32_t steps = options.samples;
+
+  // Direct calls, as loop() made them before the policies
+  SamplePipeline direct;
+  samplePipelineReset(&direct, PIPELINE_STABLE);
+  std::vector<uint8_t> directClasses(samples.size());
+  uint32_t directShown = 0;
+  BenchTimer directTimer;
+  for (uint32_t i = 0; i < steps; i++) {
+    PipelineResult result;
+    samplePipelineRun(&direct, samples[i % samples.size()], &result);
+    directShown += result.show;
+    if (i < samples.size()) {
+      directClasses[i] = (uint8_t)result.colorClass;
+    }
+  }
+  double directNs = directTimer.elapsedNs();
+
+  // Same readings from Sensor<MockSensor>, results on Display<MockDisplay>
+  BenchSensor::load(samples.data(), (uint16_t)samples.size());
+  BenchSensor::begin();
+  BenchDisplay::begin();
+  SamplePipeline scan;
+  samplePipelineReset(&scan, PIPELINE_STABLE);
+  uint32_t mismatches = 0;
+  BenchTimer scanTimer;
+  for (uint32_t i = 0; i < steps; i++) {
+    PipelineResult result;
+    if (!scanStep<BenchSensor>(&scan, &result)) {
+      mismatches++;
+      continue;
+    }
+    if (result.show) {
+      BenchDisplay::draw(nullptr, 0, 0, "", TEXT_WIDTH_MEASURE, RENDER_FULL);
+    }
+    if (i < samples.size()) {
+      mismatches += directClasses[i] != (uint8_t)result.colorClass;
+    }
+  }
+  double scanNs = scanTimer.elapsedNs();
+
+  benchReport("samplePipelineRun, direct", steps, directNs);
+  benchReport("scanStep<Sensor<MockSensor>>", steps, scanNs);
+  bool ok = mismatches == 0 && BenchDisplay::frames == directShown;
+  printf("same classes and %lu redraws as the direct calls: %s\n", (unsigned long)BenchDisplay::frames,
+         ok ? "ok" : "FAILED");
+  return ok;
+}
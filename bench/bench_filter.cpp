@@ -0,0 +1,95 @@
+/*
+ * Median filter + hysteresis on simulated sample streams: how many
+ * samples until the first answer, and how often the shown class changes
+ * compared with classifying every sample on its own.
+ */
+
+#include "bench.h"
+#include "color_filter.h"
+
+struct FilterRun {
+  uint32_t firstCommit;   // samples until the first class is shown
+  uint32_t rawChanges;    // class changes without filtering
+  uint32_t shownChanges;  // class changes shown with filtering
+};
+
+static uint8_t clampChannel(int v)
+{
+  return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+static FilterRun runStream(RGBColor center, int noise, uint32_t samples, uint32_t seed)
+{
+  BenchRng rng(seed);
+  ColorFilter filter;
+  ClassHysteresis hysteresis;
+  colorFilterReset(&filter);
+  classHysteresisReset(&hysteresis);
+
+  FilterRun run = {0, 0, 0};
+  ColorClass lastRaw = COL_UNDEFINED;
+  for (uint32_t i = 0; i < samples; i++) {
+    RGBColor c = {clampChannel(center.r + rng.noise(noise)), clampChannel(center.g + rng.noise(noise)),
+                  clampChannel(center.b + rng.noise(noise))};
+    ColorClass raw = bestMatchRGB(c, nullptr);
+    if (i > 0 && raw != lastRaw) {
+      run.rawChanges++;
+    }
+    lastRaw = raw;
+
+    colorFilterPush(&filter, c);
+    bool wasValid = hysteresis.valid;
+    if (classHysteresisUpdate(&hysteresis, bestMatchRGB(colorFilterMedian(&filter), nullptr))) {
+      if (!wasValid) {
+        run.firstCommit = i + 1;
+      } else {
+        run.shownChanges++;
+      }
+    }
+  }
+  return run;
+}
+
+bool benchFilter(const BenchOptions& options)
+{
+  (void)options;
+  printf("== temporal filter + hysteresis ==\n");
+  const uint32_t samples = 1000;
+  bool ok = true;
+
+  // Solid surfaces: every reference color with sensor noise
+  uint32_t worstFirst = 0, rawChanges = 0, shownChanges = 0;
+  for (size_t i = 0; i < color_reference_count; i++) {
+    FilterRun run = runStream(color_reference[i].reference_color, 4, samples, 10 + (uint32_t)i);
+    worstFirst = run.firstCommit > worstFirst ? run.firstCommit : worstFirst;
+    rawChanges += run.rawChanges;
+    shownChanges += run.shownChanges;
+  }
+  printf("solid surfaces: first answer after <= %u samples, class changes %u raw -> %u shown\n",
+         worstFirst, rawChanges, shownChanges);
+  ok &= worstFirst <= COLOR_FILTER_SIZE + CLASS_HYSTERESIS_SAMPLES;
+
+  // Half way between two references of different classes: the worst case for flicker
+  rawChanges = shownChanges = 0;
+  uint32_t pairs = 0;
+  for (size_t i = 0; i + 1 < color_reference_count; i++) {
+    const ColoReference& a = color_reference[i];
+    const ColoReference& b = color_reference[i + 1];
+    if (a.color_class == b.color_class) {
+      continue;
+    }
+    RGBColor mid = {(uint8_t)((a.reference_color.r + b.reference_color.r) / 2),
+                    (uint8_t)((a.reference_color.g + b.reference_color.g) / 2),
+                    (uint8_t)((a.reference_color.b + b.reference_color.b) / 2)};
+    FilterRun run = runStream(mid, 4, samples, 100 + (uint32_t)i);
+    rawChanges += run.rawChanges;
+    shownChanges += run.shownChanges;
+    pairs++;
+  }
+  printf("class boundaries (%u): class changes %u raw -> %u shown\n", pairs, rawChanges, shownChanges);
+  ok &= shownChanges <= rawChanges;
+  if (!ok) {
+    printf("FAILED: filter slower or noisier than expected\n");
+  }
+  return ok;
+}
@@ -0,0 +1,126 @@
+/*
+ * Fixed-point CIELAB: conversion cost and accuracy against a double
+ * precision reference over every 24 bit color, then Delta E matching.
+ */
+
+#include <math.h>
+
+#include "bench.h"
+#include "color_lab.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define BENCH_HAS_TSC
+#endif
+
+struct LabDouble {
+  double l, a, b;
+};
+
+static double labFDouble(double t)
+{
+  const double delta = 6.0 / 29.0;
+  return t > delta * delta * delta ? cbrt(t) : t / (3 * delta * delta) + 4.0 / 29.0;
+}
+
+static LabDouble rgbToLabDouble(const double* linear, RGBColor c)
+{
+  double r = linear[c.r], g = linear[c.g], b = linear[c.b];
+  double x = (0.4124564 * r + 0.3575761 * g + 0.1804375 * b) / 0.95047;
+  double y = 0.2126729 * r + 0.7151522 * g + 0.0721750 * b;
+  double z = (0.0193339 * r + 0.1191920 * g + 0.9503041 * b) / 1.08883;
+  LabDouble lab = {116 * labFDouble(y) - 16, 500 * (labFDouble(x) - labFDouble(y)), 200 * (labFDouble(y) - labFDouble(z))};
+  return lab;
+}
+
+static bool accuracy()
+{
+  double linear[256];
+  for (int i = 0; i < 256; i++) {
+    double v = i / 255.0;
+    linear[i] = v <= 0.04045 ? v / 12.92 : pow((v + 0.055) / 1.055, 2.4);
+  }
+  double sum = 0, worst = 0;
+  RGBColor worstColor = {0, 0, 0};
+  for (uint32_t v = 0; v < (1u << 24); v++) {
+    RGBColor c = {(uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v};
+    LabColor fixed = rgbToLab(c);
+    LabDouble ref = rgbToLabDouble(linear, c);
+    double dl = (double)fixed.l / LAB_SCALE - ref.l;
+    double da = (double)fixed.a / LAB_SCALE - ref.a;
+    double db = (double)fixed.b / LAB_SCALE - ref.b;
+    double de = sqrt(dl * dl + da * da + db * db);
+    sum += de;
+    if (de > worst) {
+      worst = de;
+      worstColor = c;
+    }
+  }
+  printf("rgbToLab vs double: mean error %.4f dE, max %.4f dE at (%u,%u,%u)\n",
+         sum / (1u << 24), worst, worstColor.r, worstColor.g, worstColor.b);
+  // Well below the ~1 dE just noticeable difference
+  return worst < 0.5;
+}
+
+static void conversionCost(const std::vector<RGBColor>& samples)
+{
+  uint32_t checksum = 0;
+#ifdef BENCH_HAS_TSC
+  uint64_t cycles = __rdtsc();
+#endif
+  BenchTimer timer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    LabColor lab = rgbToLab(samples[i]);
+    checksum += (uint16_t)(lab.l + lab.a + lab.b);
+  }
+  double ns = timer.elapsedNs();
+#ifdef BENCH_HAS_TSC
+  cycles = __rdtsc() - cycles;
+  printf("rgbToLab: %.2f ns, %.1f TSC cycles per conversion\n", ns / samples.size(), (double)cycles / samples.size());
+#else
+  printf("rgbToLab: %.2f ns per conversion\n", ns / samples.size());
+#endif
+  bench_sink += checksum;
+}
+
+static void runLab(const char* name, const ColoReference* table, size_t count, const std::vector<RGBColor>& samples)
+{
+  std::vector<LabColor> labTable(count);
+  for (size_t i = 0; i < count; i++) {
+    labTable[i] = rgbToLab(table[i].reference_color);
+  }
+  size_t same = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    if (bestMatchLabTable(table, labTable.data(), count, samples[i], nullptr) == bestMatchRGBTable(table, count, samples[i], nullptr)) {
+      same++;
+    }
+  }
+
+  uint32_t checksum = 0;
+  BenchTimer timer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint32_t minDist;
+    checksum += (uint32_t)bestMatchLabTable(table, labTable.data(), count, samples[i], &minDist) + minDist;
+  }
+  double ns = timer.elapsedNs();
+  bench_sink += checksum;
+  benchReport(name, samples.size(), ns);
+  printf("  same class as the RGB distance for %.2f%% of the samples\n", 100.0 * same / samples.size());
+}
+
+bool benchLab(const BenchOptions& options)
+{
+  printf("== CIELAB fixed point ==\n");
+  bool ok = accuracy();
+  std::vector<RGBColor> uniform = benchUniformSamples(options.samples, 1);
+  conversionCost(uniform);
+
+  std::vector<RGBColor> nanoJitter = benchJitteredSamples(color_reference_nano, color_reference_nano_count, options.samples, 2);
+  std::vector<RGBColor> espJitter = benchJitteredSamples(color_reference_esp32c3, color_reference_esp32c3_count, options.samples, 3);
+  runLab("nano/lab/jittered", color_reference_nano, color_reference_nano_count, nanoJitter);
+  runLab("esp32c3/lab/jittered", color_reference_esp32c3, color_reference_esp32c3_count, espJitter);
+  if (!ok) {
+    printf("FAILED: fixed point CIELAB error too large\n");
+  }
+  return ok;
+}
@@ -0,0 +1,118 @@
+/*
+ * Loop profiler (LOOP_PROFILE): log2 bin edges, laps across a wrap of the
+ * tick counter, saturated counts, and the report of a modelled Nano loop
+ * (blocking TCS34725, full SSD1306 frame, text log at 9600 baud, 500 ms
+ * pause) fed through a fake clock. The stage times of the model are
+ * estimates, not measurements. Cost of one lap on the host.
+ */
+
+#include "bench.h"
+#include "loop_profile.h"
+
+struct ModelStage {
+  LoopStage stage;
+  uint32_t us;        // mean duration
+  uint32_t jitter;    // +/- uniform
+};
+
+// In the order loop() runs them
+static const ModelStage nano_loop[] = {
+  {LOOP_OTHER, 8, 4},
+  {LOOP_SENSOR, 24600, 300},   // 24 ms integration waited inside getRawData(), then I2C
+  {LOOP_SERIAL, 1200, 200},    // "Red: ..." line into the 64 byte TX buffer
+  {LOOP_MATCH, 180, 20},       // median filter and bestMatchRGB()
+  {LOOP_SERIAL, 300, 50},      // distance
+  {LOOP_RENDER, 2100, 100},    // icon and name into the framebuffer
+  {LOOP_FLUSH, 23500, 500},    // 1 KB at 400 kHz
+  {LOOP_SERIAL, 300, 50},      // class name
+  {LOOP_WAIT, 500000, 1000},   // sampleWait(500)
+};
+
+static void printReport(const LoopProfile* profile)
+{
+  for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    LoopStage stage = (LoopStage)i;
+    printf("  %-7s n %4u  p50 <= %7u  p99 <= %7u  max %7u us\n", loopStageName(stage), loopProfileCount(profile, stage),
+           loopProfilePercentile(profile, stage, 50) / profile->ticksPerUs,
+           loopProfilePercentile(profile, stage, 99) / profile->ticksPerUs,
+           profile->maxTicks[stage] / profile->ticksPerUs);
+  }
+}
+
+bool benchLoop(const BenchOptions& options)
+{
+  printf("== loop profiler ==\n");
+  bool ok = true;
+
+  // Bin b holds b significant bits, the last one everything longer
+  bool binsOk = loopProfileBin(0) == 0 && loopProfileBin(1) == 1 && loopProfileBin(3) == 2 &&
+                loopProfileBin(4) == 3 && loopProfileBin(0xFFFFFFFF) == LOOP_PROFILE_BINS - 1 &&
+                loopProfileBinTop(LOOP_PROFILE_BINS - 1) == 0xFFFFFFFF;
+  for (uint8_t b = 1; b + 1 < LOOP_PROFILE_BINS; b++) {
+    uint32_t top = loopProfileBinTop(b);
+    binsOk &= loopProfileBin(top) == b && loopProfileBin(top + 1) == b + 1;
+  }
+
+  // A lap across the wrap of the counter, and counts stopping at 65535
+  static LoopProfile profile;
+  loopProfileReset(&profile, 1, 0xFFFFFF00u);
+  loopProfileLap(&profile, LOOP_FLUSH, 0x100);
+  bool wrapOk = profile.maxTicks[LOOP_FLUSH] == 0x200 && profile.bins[LOOP_FLUSH][loopProfileBin(0x200)] == 1;
+  for (uint32_t i = 0; i < 70000; i++) {
+    loopProfileAdd(&profile, LOOP_OTHER, 5);
+  }
+  bool saturateOk = profile.bins[LOOP_OTHER][loopProfileBin(5)] == 0xFFFF;
+  printf("bin edges %s, lap across the counter wrap %s, counts saturate %s\n", binsOk ? "ok" : "FAILED",
+         wrapOk ? "ok" : "FAILED", saturateOk ? "ok" : "FAILED");
+  ok &= binsOk && wrapOk && saturateOk;
+
+  // The modelled loop on a fake micros(), started close to its wrap
+  const uint32_t iterations = 200;
+  uint32_t now = 0xFFF00000u;
+  uint64_t spent[LOOP_STAGE_COUNT] = {0};
+  BenchRng rng(31);
+  loopProfileReset(&profile, 1, now);
+  for (uint32_t n = 0; n < iterations; n++) {
+    for (size_t i = 0; i < sizeof(nano_loop) / sizeof(nano_loop[0]); i++) {
+      const ModelStage& m = nano_loop[i];
+      uint32_t us = m.us - m.jitter + rng.next() % (2 * m.jitter + 1);
+      now += us;
+      spent[m.stage] += us;
+      loopProfileLap(&profile, m.stage, now);
+      if (m.stage == LOOP_MATCH) {
+        loopProfileReading(&profile, now);
+      }
+    }
+  }
+  printf("modelled Nano loop, %u readings:\n", iterations);
+  printReport(&profile);
+  // Every modelled duration lands within a factor of two under its percentile
+  bool modelOk = loopProfileCount(&profile, LOOP_CYCLE) == iterations - 1 &&
+                 loopProfileCount(&profile, LOOP_SERIAL) == 3 * iterations;
+  for (size_t i = 0; i < sizeof(nano_loop) / sizeof(nano_loop[0]); i++) {
+    const ModelStage& m = nano_loop[i];
+    if (m.stage == LOOP_SERIAL) {
+      continue;
+    }
+    uint32_t p50 = loopProfilePercentile(&profile, m.stage, 50);
+    modelOk &= p50 >= m.us - m.jitter && p50 / 2 < m.us + m.jitter;
+  }
+  uint64_t cycle = 0;
+  for (uint8_t s = 0; s < LOOP_CYCLE; s++) {
+    cycle += spent[s];
+  }
+  printf("cycle %.1f ms: wait %.0f%%, sensor %.0f%%, flush %.0f%%, serial %.0f%%: %s\n",
+         cycle / 1000.0 / iterations, 100.0 * spent[LOOP_WAIT] / cycle, 100.0 * spent[LOOP_SENSOR] / cycle,
+         100.0 * spent[LOOP_FLUSH] / cycle, 100.0 * spent[LOOP_SERIAL] / cycle, modelOk ? "ok" : "FAILED");
+  ok &= modelOk;
+
+  // What the instrumentation adds to each stage
+  const uint32_t laps = options.samples;
+  BenchTimer timer;
+  for (uint32_t i = 0; i < laps; i++) {
+    loopProfileLap(&profile, (LoopStage)(i % LOOP_CYCLE), i * 37);
+  }
+  bench_sink += profile.maxTicks[LOOP_SENSOR];
+  benchReport("loopProfileLap", laps, timer.elapsedNs());
+  return ok;
+}
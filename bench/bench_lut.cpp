@@ -0,0 +1,114 @@
+/*
+ * RGB cube (color_lut.h) against the linear scan: every one of the 2^24
+ * colors must get the class of bestMatchRGBTable(), the cells where the
+ * answer changes through the short reference list they point to. Then how
+ * many samples need a list, how long the lists are, and the time of the
+ * cube against the scan on the same samples: the cube has to be faster.
+ */
+
+#include "bench.h"
+#include "color_lut.h"
+
+// Colors of all 2^24 that the cube classifies unlike the linear scan
+static uint32_t disagreements(const ColoReference* table, size_t count, const ColorLut* lut)
+{
+  uint32_t differ = 0;
+  for (uint32_t v = 0; v < (1u << 24); v++) {
+    RGBColor c = {(uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v};
+    if (bestMatchRGBLut(lut, table, c) != bestMatchRGBTable(table, count, c, nullptr)) {
+      differ++;
+    }
+  }
+  return differ;
+}
+
+// References of the list of a cell, 0 when the cell decides alone
+static uint16_t listLength(const ColorLut* lut, uint8_t cell)
+{
+  if (cell < COLOR_LUT_LISTS) {
+    return 0;
+  }
+  uint8_t list = cell - COLOR_LUT_LISTS;
+  return pgm_read_word(lut->starts + list + 1) - pgm_read_word(lut->starts + list);
+}
+
+// Best of three runs, against the noise of the host
+template <typename Run>
+static double bestOfThree(Run run, size_t samples)
+{
+  double best = 0;
+  for (int i = 0; i < 3; i++) {
+    BenchTimer timer;
+    bench_sink += run();
+    double ns = timer.elapsedNs();
+    best = i == 0 || ns < best ? ns : best;
+  }
+  return best / samples;
+}
+
+static bool runLut(const char* name, const ColoReference* table, size_t count, const ColorLut* lut,
+                   const std::vector<RGBColor>& samples)
+{
+  uint32_t side = 1u << lut->bits;
+  uint32_t cells = side * side * side;
+  uint32_t listCells = 0;
+  uint32_t lists = 0;
+  for (uint32_t i = 0; i < cells; i++) {
+    uint8_t cell = pgm_read_byte(lut->cells + i);
+    if (cell >= COLOR_LUT_LISTS) {
+      listCells++;
+      lists = cell - COLOR_LUT_LISTS + 1u > lists ? cell - COLOR_LUT_LISTS + 1u : lists;
+    }
+  }
+  size_t flash = cells + (lists + 1) * sizeof(uint16_t) + pgm_read_word(lut->starts + lists);
+
+  uint32_t sampleLists = 0, sampleRefs = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint16_t n = listLength(lut, colorLutCell(lut, samples[i]));
+    sampleLists += n > 0;
+    sampleRefs += n;
+  }
+  uint32_t differ = disagreements(table, count, lut);
+  printf("%s: %zu bytes, %u/%u cells with a list, %.1f%% of the samples on one, %.2f references each, "
+         "%u of 2^24 RGB values differ from the scan\n",
+         name, flash, listCells, cells, 100.0 * sampleLists / samples.size(),
+         sampleLists ? (double)sampleRefs / sampleLists : 0.0, differ);
+
+  double lutNs = bestOfThree([&]() {
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+      checksum += (uint32_t)bestMatchRGBLut(lut, table, samples[i]);
+    }
+    return checksum;
+  }, samples.size());
+  double scanNs = bestOfThree([&]() {
+    uint32_t checksum = 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+      checksum += (uint32_t)bestMatchRGBTable(table, count, samples[i], nullptr);
+    }
+    return checksum;
+  }, samples.size());
+  bool faster = lutNs < scanNs;
+  printf("  cube %.2f ns/sample, linear scan %.2f ns/sample: %.1fx%s\n", lutNs, scanNs, scanNs / lutNs,
+         faster ? "" : "  FAILED: the cube is not faster");
+  return differ == 0 && faster;
+}
+
+bool benchLut(const BenchOptions& options)
+{
+  printf("== classifier (RGB cube) ==\n");
+  std::vector<RGBColor> nanoJitter = benchJitteredSamples(color_reference_nano, color_reference_nano_count, options.samples, 2);
+  std::vector<RGBColor> espJitter = benchJitteredSamples(color_reference_esp32c3, color_reference_esp32c3_count, options.samples, 3);
+
+  bool ok = true;
+  ok &= runLut("nano/lut4/jittered", color_reference_nano, color_reference_nano_count, &color_reference_nano_lut4, nanoJitter);
+  ok &= runLut("nano/lut5/jittered", color_reference_nano, color_reference_nano_count, &color_reference_nano_lut5, nanoJitter);
+  ok &= runLut("esp32c3/lut4/jittered", color_reference_esp32c3, color_reference_esp32c3_count, &color_reference_esp32c3_lut4,
+               espJitter);
+  ok &= runLut("esp32c3/lut5/jittered", color_reference_esp32c3, color_reference_esp32c3_count, &color_reference_esp32c3_lut5,
+               espJitter);
+  if (!ok) {
+    printf("FAILED: color_lut.h is out of date or wrong, run tools/gen_color_lut.py\n");
+  }
+  return ok;
+}
@@ -0,0 +1,110 @@
+/*
+ * Color Blind Helper - host benchmarks
+ *
+ * Usage: pio run -e native && .pio/build/native/program [samples] [recorded.csv] [trace.csv]
+ * Exit code is 1 when one of the correctness checks fails.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+volatile uint32_t bench_sink = 0;
+
+void benchReport(const char* name, size_t samples, double ns)
+{
+  double perSample = ns / samples;
+  printf("%-40s %10zu samples %9.2f ns/sample %12.0f classes/sec\n",
+         name, samples, perSample, 1e9 / perSample);
+}
+
+std::vector<RGBColor> benchUniformSamples(size_t count, uint32_t seed)
+{
+  BenchRng rng(seed);
+  std::vector<RGBColor> samples(count);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t v = rng.next();
+    samples[i].r = (uint8_t)v;
+    samples[i].g = (uint8_t)(v >> 8);
+    samples[i].b = (uint8_t)(v >> 16);
+  }
+  return samples;
+}
+
+static uint8_t clampChannel(int v)
+{
+  return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+// Reference colors plus sensor-like noise: what the device sees on real surfaces
+std::vector<RGBColor> benchJitteredSamples(const ColoReference* table, size_t tableCount, size_t count, uint32_t seed)
+{
+  BenchRng rng(seed);
+  std::vector<RGBColor> samples(count);
+  for (size_t i = 0; i < count; i++) {
+    const RGBColor& ref = table[rng.next() % tableCount].reference_color;
+    samples[i].r = clampChannel(ref.r + rng.noise(12));
+    samples[i].g = clampChannel(ref.g + rng.noise(12));
+    samples[i].b = clampChannel(ref.b + rng.noise(12));
+  }
+  return samples;
+}
+
+bool benchLoadRecorded(const char* path, std::vector<RGBColor>& out)
+{
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    return false;
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    int r, g, b;
+    if (sscanf(line, "%d,%d,%d", &r, &g, &b) == 3) {
+      RGBColor c = {clampChannel(r), clampChannel(g), clampChannel(b)};
+      out.push_back(c);
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char** argv)
+{
+  BenchOptions options;
+  options.samples = 4000000;
+  options.recordedPath = nullptr;
+  options.tracePath = nullptr;
+  if (argc > 1) {
+    options.samples = (uint32_t)strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    options.recordedPath = argv[2];
+  }
+  if (argc > 3) {
+    options.tracePath = argv[3];
+  }
+
+  bool ok = true;
+  ok &= benchClassifier(options);
+  ok &= benchLut(options);
+  ok &= benchPalette(options);
+  ok &= benchLab(options);
+  ok &= benchRanging(options);
+  ok &= benchConversion(options);
+  ok &= benchFilter(options);
+  ok &= benchRender(options);
+  ok &= benchTelemetry(options);
+  ok &= benchCalibration(options);
+  ok &= benchConfig(options);
+  ok &= benchBoot(options);
+  ok &= benchMemory(options);
+  ok &= benchLoop(options);
+  ok &= benchPower(options);
+  ok &= benchReplay(options);
+  ok &= benchBurst(options);
+  ok &= benchPipeline(options);
+  ok &= benchDrivers(options);
+  ok &= benchSweep(options);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+/*
+ * Memory instrumentation: the stack high-water mark found by painting a
+ * simulated AVR RAM and growing a stack into it, memory frame round trip
+ * with every single bit error caught by the CRC.
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "mem_stats.h"
+#include "telemetry.h"
+
+bool benchMemory(const BenchOptions& options)
+{
+  (void)options;
+  printf("== memory instrumentation ==\n");
+
+  // 2 KB of RAM: 600 bytes of globals and heap, stack from the top down.
+  // Painted at boot, then the stack goes 700 bytes deep once and returns
+  uint8_t ram[2048];
+  memset(ram, 0x11, sizeof(ram));
+  uint8_t* heapTop = ram + 600;
+  uint8_t* sp = ram + sizeof(ram) - 40;
+  memPaint(heapTop, sp);
+  memset(ram + sizeof(ram) - 700, 0x00, 700 - 40);   // zeros as well: an overwrite is not always a different value
+  uint32_t untouched = memPaintedBytes(heapTop, sp);
+  uint32_t peak = (uint32_t)(ram + sizeof(ram) - (heapTop + untouched));
+  bool paintOk = untouched == sizeof(ram) - 700 - 600 && peak == 700 && memPaintedBytes(sp, sp) == 0;
+
+  MemStats stats = {1234, untouched, peak, 0x0258};
+  uint8_t frame[TELEMETRY_MEM_FRAME_SIZE];
+  telemetryEncodeMem(&stats, frame);
+  MemStats back;
+  bool roundTrip = telemetryDecodeMem(frame, &back) && back.freeRam == stats.freeRam &&
+                   back.stackFree == stats.stackFree && back.stackPeak == stats.stackPeak &&
+                   back.heapBreak == stats.heapBreak;
+  uint32_t accepted = 0;
+  for (uint16_t bit = 0; bit < TELEMETRY_MEM_FRAME_SIZE * 8; bit++) {
+    frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    if (telemetryDecodeMem(frame, &back)) {
+      accepted++;
+    }
+    frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+  }
+  printf("stack peak %u bytes, %u never used: %s; memory frame %u bytes, round trip %s, single bit errors accepted: %u\n",
+         peak, untouched, paintOk ? "ok" : "FAILED", (unsigned)TELEMETRY_MEM_FRAME_SIZE, roundTrip ? "ok" : "FAILED",
+         accepted);
+  return paintOk && roundTrip && accepted == 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * k-d tree palette search against a linear scan for 24, 150, 500 and 1000
+ * entries. The search must always find a color at the same distance.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include "bench.h"
+#include "palette.h"
+#include "palette_css.h"
+
+struct BenchPalette {
+  std::vector<PaletteEntry> entries;
+  std::string names;
+  Palette palette;
+};
+
+// Same ordering as tools/gen_palette.py
+static void kdOrder(std::vector<PaletteEntry>& entries, size_t lo, size_t hi, int axis)
+{
+  if (hi - lo <= 1) {
+    return;
+  }
+  std::stable_sort(entries.begin() + lo, entries.begin() + hi, [axis](const PaletteEntry& a, const PaletteEntry& b) {
+    const uint8_t pa[3] = {a.r, a.g, a.b};
+    const uint8_t pb[3] = {b.r, b.g, b.b};
+    return pa[axis] < pb[axis];
+  });
+  size_t mid = lo + (hi - lo) / 2;
+  kdOrder(entries, lo, mid, (axis + 1) % 3);
+  kdOrder(entries, mid + 1, hi, (axis + 1) % 3);
+}
+
+static void finishPalette(BenchPalette& p)
+{
+  kdOrder(p.entries, 0, p.entries.size(), 0);
+  p.names = std::string("x", 1) + '\0';
+  p.palette.entries = p.entries.data();
+  p.palette.count = (uint16_t)p.entries.size();
+  p.palette.names = p.names.c_str();
+}
+
+static void randomPalette(BenchPalette& p, size_t count, uint32_t seed)
+{
+  BenchRng rng(seed);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t v = rng.next();
+    PaletteEntry e = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), 0};
+    p.entries.push_back(e);
+  }
+  finishPalette(p);
+}
+
+static uint32_t linearNearest(const Palette& palette, RGBColor c, uint32_t threshold)
+{
+  uint32_t best = 0xFFFFFFFF;
+  for (uint16_t i = 0; i < palette.count; i++) {
+    const PaletteEntry& e = palette.entries[i];
+    int dr = c.r - e.r, dg = c.g - e.g, db = c.b - e.b;
+    uint32_t dist = dr*dr + dg*dg + db*db;
+    if (dist < best && dist <= threshold) {
+      best = dist;
+    }
+  }
+  return best;
+}
+
+static bool runPalette(const char* name, const Palette& palette, uint32_t threshold, const std::vector<RGBColor>& samples)
+{
+  uint32_t wrong = 0;
+  for (size_t i = 0; i < samples.size() && i < 200000; i++) {
+    uint32_t dist;
+    paletteNearest(&palette, samples[i], threshold, &dist);
+    if (dist != linearNearest(palette, samples[i], threshold)) {
+      wrong++;
+    }
+  }
+
+  uint32_t checksum = 0;
+  BenchTimer linearTimer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    checksum += linearNearest(palette, samples[i], threshold);
+  }
+  double linearNs = linearTimer.elapsedNs();
+
+  palette_visits = 0;
+  BenchTimer kdTimer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    checksum += (uint32_t)paletteNearest(&palette, samples[i], threshold, nullptr);
+  }
+  double kdNs = kdTimer.elapsedNs();
+  bench_sink += checksum;
+
+  printf("%-22s %5u entries  linear %8.2f ns  kd-tree %7.2f ns  %6.1f nodes/lookup  %s\n",
+         name, palette.count, linearNs / samples.size(), kdNs / samples.size(),
+         (double)palette_visits / samples.size(), wrong ? "MISMATCH" : "ok");
+  return wrong == 0;
+}
+
+bool benchPalette(const BenchOptions& options)
+{
+  printf("== palette index (k-d tree) ==\n");
+  std::vector<RGBColor> samples = benchUniformSamples(options.samples / 4, 5);
+  bool ok = true;
+
+  BenchPalette nano;
+  for (size_t i = 0; i < color_reference_nano_count; i++) {
+    const RGBColor& c = color_reference_nano[i].reference_color;
+    PaletteEntry e = {c.r, c.g, c.b, 0};
+    nano.entries.push_back(e);
+  }
+  finishPalette(nano);
+  std::vector<RGBColor> jitter = benchJitteredSamples(color_reference_nano, color_reference_nano_count, options.samples / 4, 2);
+  ok &= runPalette("nano/threshold", nano.palette, THRESHOLD, jitter);
+  ok &= runPalette("nano/uniform", nano.palette, 0xFFFFFFFF, samples);
+
+  ok &= runPalette("css/uniform", palette_css, PALETTE_THRESHOLD, samples);
+
+  const size_t sizes[] = {150, 500, 1000};
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    BenchPalette random;
+    randomPalette(random, sizes[i], 100 + (uint32_t)i);
+    char name[32];
+    snprintf(name, sizeof(name), "random%zu/uniform", sizes[i]);
+    ok &= runPalette(name, random.palette, 0xFFFFFFFF, samples);
+  }
+  return ok;
+}
@@ -0,0 +1,238 @@
+/*
+ * Pipelined tasks (PIPELINED_TASKS): the render mailbox hammered by two
+ * threads, then loop() and renderTask() modelled with threads and sleeps
+ * to compare the period of one reading, sequential and pipelined.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bench.h"
+#include "render_mailbox.h"
+
+// Every field derived from seq: a torn slot shows up as a mismatch
+static RenderJob stressJob(uint32_t seq)
+{
+  RenderJob job;
+  job.seq = seq;
+  job.color.r = (uint8_t)seq;
+  job.color.g = (uint8_t)(seq >> 8);
+  job.color.b = (uint8_t)(job.color.r ^ job.color.g);
+  job.colorClass = (ColorClass)(seq % COLOR_CLASS_COUNT);
+  job.distance = seq * 3;
+  job.postedUs = ~seq;
+  return job;
+}
+
+static bool sameJob(const RenderJob& a, const RenderJob& b)
+{
+  return a.seq == b.seq && a.color.r == b.color.r && a.color.g == b.color.g && a.color.b == b.color.b &&
+         a.colorClass == b.colorClass && a.distance == b.distance && a.postedUs == b.postedUs;
+}
+
+// xTaskNotifyGive() / ulTaskNotifyTake() on the host
+class Notify {
+public:
+  Notify() : pending_(false) {}
+  void give() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ = true;
+    cv_.notify_one();
+  }
+  void take() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pending_; });
+    pending_ = false;
+  }
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool pending_;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static uint32_t nowUs(Clock::time_point start)
+{
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+struct PipelineTiming {
+  std::chrono::microseconds integration;  // sensor integrating, bus free
+  std::chrono::microseconds poll;         // reading the result, bus taken
+  std::chrono::microseconds flush;        // frame to the display, bus taken
+  bool sharedBus;                         // false: display on its own bus (SPI)
+};
+
+struct PipelineRun {
+  double periodUs;        // per reading
+  double latencyUs;       // posted to drawn, mean
+  uint32_t drawn;
+  uint32_t coalesced;
+  uint32_t lastDrawn;
+};
+
+// loop() drawing by itself: integration, poll and flush one after the other
+static PipelineRun runSequential(const PipelineTiming& t, uint32_t readings)
+{
+  Clock::time_point start = Clock::now();
+  for (uint32_t i = 0; i < readings; i++) {
+    std::this_thread::sleep_for(t.integration);
+    std::this_thread::sleep_for(t.poll);
+    std::this_thread::sleep_for(t.flush);
+  }
+  PipelineRun run;
+  run.periodUs = (double)nowUs(start) / readings;
+  run.latencyUs = 0;
+  run.drawn = readings;
+  run.coalesced = 0;
+  run.lastDrawn = readings - 1;
+  return run;
+}
+
+// loop() posts, renderTask() draws; both take the bus mutex for their transfers
+static PipelineRun runPipelined(const PipelineTiming& t, uint32_t readings)
+{
+  RenderMailbox mailbox;
+  renderMailboxReset(&mailbox);
+  std::mutex bus;
+  Notify notify;
+  std::atomic<bool> done(false);
+  uint32_t drawn = 0, lastDrawn = 0;
+  uint64_t latencyUs = 0;
+  Clock::time_point start = Clock::now();
+
+  std::thread render([&] {
+    RenderJob job;
+    for (;;) {
+      notify.take();
+      // Read before draining: every post made before done is drained below
+      bool finished = done.load();
+      while (renderMailboxTake(&mailbox, &job)) {
+        latencyUs += nowUs(start) - job.postedUs;
+        if (t.sharedBus) {
+          std::lock_guard<std::mutex> lock(bus);
+          std::this_thread::sleep_for(t.flush);
+        } else {
+          std::this_thread::sleep_for(t.flush);
+        }
+        drawn++;
+        lastDrawn = job.seq;
+      }
+      if (finished) {
+        return;
+      }
+    }
+  });
+
+  for (uint32_t i = 0; i < readings; i++) {
+    std::this_thread::sleep_for(t.integration);
+    {
+      std::lock_guard<std::mutex> lock(bus);
+      std::this_thread::sleep_for(t.poll);
+    }
+    RenderJob job = stressJob(i);
+    job.postedUs = nowUs(start);
+    renderMailboxPost(&mailbox, &job);
+    notify.give();
+  }
+  double periodUs = (double)nowUs(start) / readings;
+  done.store(true);
+  notify.give();
+  render.join();
+
+  PipelineRun run;
+  run.periodUs = periodUs;
+  run.latencyUs = drawn ? (double)latencyUs / drawn : 0;
+  run.drawn = drawn;
+  run.coalesced = mailbox.coalesced;
+  run.lastDrawn = lastDrawn;
+  return run;
+}
+
+static void printRun(const char* name, const PipelineRun& run, uint32_t readings)
+{
+  printf("%-26s %7.0f us per reading, %u of %u drawn, %u coalesced, %6.0f us posted to drawn\n", name,
+         run.periodUs, run.drawn, readings, run.coalesced, run.latencyUs);
+}
+
+bool benchPipeline(const BenchOptions& options)
+{
+  printf("== pipelined tasks ==\n");
+  bool ok = true;
+
+  // One writer, one reader spinning: numbers only go up, no slot is torn,
+  // and every result is either drawn or counted as coalesced
+  const uint32_t posts = options.samples < 50000 ? 50000 : options.samples;
+  RenderMailbox mailbox;
+  renderMailboxReset(&mailbox);
+  uint32_t taken = 0, torn = 0, backwards = 0;
+  std::atomic<bool> started(false);
+  BenchTimer stressTimer;
+  std::thread reader([&] {
+    RenderJob job;
+    started.store(true);
+    bool first = true;
+    uint32_t last = 0;
+    for (;;) {
+      if (!renderMailboxTake(&mailbox, &job)) {
+        std::this_thread::yield();
+        continue;
+      }
+      taken++;
+      torn += !sameJob(job, stressJob(job.seq));
+      backwards += !first && job.seq <= last;
+      first = false;
+      last = job.seq;
+      if (job.seq == posts - 1) {
+        return;
+      }
+    }
+  });
+  while (!started.load()) {
+  }
+  for (uint32_t i = 0; i < posts; i++) {
+    RenderJob job = stressJob(i);
+    renderMailboxPost(&mailbox, &job);
+    if ((i & 15) == 0) {
+      // Interleave the two sides even on a single core
+      std::this_thread::yield();
+    }
+  }
+  reader.join();
+  benchReport("renderMailboxPost/Take, two threads", posts, stressTimer.elapsedNs());
+  bool stressOk = taken > 1 && torn == 0 && backwards == 0 && taken + mailbox.coalesced == posts;
+  printf("%u posted, %u taken, %u coalesced, %u torn, %u out of order: %s\n", posts, taken, mailbox.coalesced,
+         torn, backwards, stressOk ? "ok" : "FAILED");
+  ok &= stressOk;
+
+  // TCS34725 at 24 ms integration and a full SSD1306 frame at 400 kHz
+  // (~23 ms), scaled down by 10 so the run stays short
+  const uint32_t readings = 60;
+  PipelineTiming display = {std::chrono::microseconds(2400), std::chrono::microseconds(50),
+                            std::chrono::microseconds(2300), true};
+  PipelineRun sequential = runSequential(display, readings);
+  PipelineRun pipelined = runPipelined(display, readings);
+  printRun("sequential", sequential, readings);
+  printRun("pipelined", pipelined, readings);
+  // The flush hides behind the next integration: well under the sum of the two
+  bool fasterOk = pipelined.periodUs < sequential.periodUs * 0.8 && pipelined.lastDrawn == readings - 1;
+  printf("pipelined period %.0f%% of sequential: %s\n", 100.0 * pipelined.periodUs / sequential.periodUs,
+         fasterOk ? "ok" : "FAILED");
+  ok &= fasterOk;
+
+  // A display on its own bus and slower than the sensor: the sensor keeps
+  // its pace, results are dropped instead of queued, and the last one
+  // posted is the one left on the screen
+  PipelineTiming slow = {std::chrono::microseconds(2400), std::chrono::microseconds(50),
+                         std::chrono::microseconds(6000), false};
+  PipelineRun behind = runPipelined(slow, readings);
+  printRun("pipelined, slow display", behind, readings);
+  bool latestOk = behind.coalesced > 0 && behind.lastDrawn == readings - 1 &&
+                  behind.drawn + behind.coalesced == readings && behind.periodUs < pipelined.periodUs * 1.5;
+  printf("slow display ends on the latest result: %s\n", latestOk ? "ok" : "FAILED");
+  ok &= latestOk;
+  return ok;
+}
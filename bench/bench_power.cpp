@@ -0,0 +1,78 @@
+/*
+ * Energy model of the scan loop: one minute of samples with the plain
+ * delay() pause and with LOW_POWER, average current, duty cycle and hours
+ * on a 9 V battery. The currents are typical datasheet figures, not
+ * measurements: change them to the ones of your board.
+ */
+
+#include "bench.h"
+#include "power_model.h"
+
+#define BATTERY_MAH 500           // alkaline 9 V block
+
+struct ScanTiming {
+  uint32_t integrationUs;         // one sensor integration
+  uint32_t activeUs;              // read, classify, draw
+  uint32_t pauseUs;               // pause between samples
+  uint32_t wakeUs;                // sensor warm-up after power down (LOW_POWER only)
+};
+
+static void simulate(PowerModel* model, const ScanTiming& t, bool lowPower, uint32_t seconds)
+{
+  powerModelReset(model);
+  uint64_t total = 0;
+  while (total < (uint64_t)seconds * 1000000) {
+    uint32_t integration = t.integrationUs + (lowPower ? t.wakeUs : 0);
+    powerModelAdd(model, POWER_INTEGRATING, integration);
+    powerModelAdd(model, POWER_ACTIVE, t.activeUs);
+    powerModelAdd(model, POWER_IDLE, t.pauseUs);
+    total += integration + t.activeUs + t.pauseUs;
+  }
+}
+
+static uint32_t report(const char* name, const PowerModel* model, const PowerProfile* profile)
+{
+  uint32_t average = powerModelAverageUa(model, profile);
+  printf("%-28s %6.2f mA average, sampling %5.1f%%, %4u h on %u mAh\n", name, average / 1000.0,
+         (powerModelDutyPermille(model, POWER_ACTIVE) + powerModelDutyPermille(model, POWER_INTEGRATING)) / 10.0,
+         powerModelBatteryHours(model, profile, BATTERY_MAH), BATTERY_MAH);
+  return average;
+}
+
+bool benchPower(const BenchOptions& options)
+{
+  (void)options;
+  printf("== power model ==\n");
+  // Nano: ATmega328 at 16 MHz ~15 mA, OLED with text ~8 mA, TCS34725 0.24 mA
+  // active + module LED ~4 mA, regulator and power LED ~5 mA
+  const PowerProfile nanoDelay = {{32000, 32000, 32000}};
+  const PowerProfile nanoLowPower = {{32000, 26000, 13000}};   // idle mode while integrating, power-down between
+  const PowerProfile nanoLowPowerSensorOn = {{32000, 26000, 17200}};
+  // ESP32-C3 at 160 MHz without radio ~20 mA, light sleep ~0.3 mA
+  const PowerProfile espDelay = {{37000, 37000, 37000}};
+  const PowerProfile espLowPower = {{37000, 37000, 13500}};
+
+  const ScanTiming scan500 = {24000, 4000, 500000, 3000};
+  const ScanTiming stable = {24000, 4000, 10000, 0};
+  bool ok = true;
+
+  PowerModel always, low;
+  simulate(&always, scan500, false, 60);
+  simulate(&low, scan500, true, 60);
+  uint32_t permille = 0;
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    permille += powerModelDutyPermille(&low, (PowerPhase)i);
+  }
+  ok &= permille >= 998 && permille <= 1000;
+  ok &= report("nano/delay(500)", &always, &nanoDelay) > report("nano/LOW_POWER 500 ms", &low, &nanoLowPower);
+  ok &= report("esp32c3/delay(500)", &always, &espDelay) > report("esp32c3/LOW_POWER 500 ms", &low, &espLowPower);
+
+  // STABLE_DETECTION pauses are short: the sensor stays on, only the CPU sleeps
+  simulate(&always, stable, false, 60);
+  simulate(&low, stable, true, 60);
+  ok &= report("nano/delay(10)", &always, &nanoDelay) >= report("nano/LOW_POWER 10 ms", &low, &nanoLowPowerSensorOn);
+  if (!ok) {
+    printf("FAILED: inconsistent power model\n");
+  }
+  return ok;
+}
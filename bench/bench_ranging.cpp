@@ -0,0 +1,51 @@
+/*
+ * TCS34725 automatic ranging on simulated surfaces: readings and
+ * integration time needed before the first usable sample.
+ */
+
+#include "bench.h"
+#include "tcs34725_ranging.h"
+
+// Clear count the sensor would give for a surface of the given brightness
+// (counts per 2.4 ms cycle at 1x gain)
+static TCS34725Raw simulate(uint8_t step, double brightness)
+{
+  static const uint8_t gainFactor[4] = {1, 4, 16, 60};
+  TCS34725Step s = tcs34725RangingStep(step);
+  double c = brightness * (256 - s.atime) * gainFactor[s.gain];
+  double max = tcs34725RangingMaxCount(step);
+  TCS34725Raw raw;
+  raw.c = (uint16_t)(c > max ? max : c);
+  raw.r = raw.g = raw.b = raw.c / 3;
+  return raw;
+}
+
+bool benchRanging(const BenchOptions& options)
+{
+  (void)options;
+  printf("== TCS34725 ranging ==\n");
+  bool ok = true;
+  const double surfaces[] = {0.02, 0.2, 1, 5, 20, 100, 400, 900, 5000};
+  for (size_t i = 0; i < sizeof(surfaces) / sizeof(surfaces[0]); i++) {
+    uint8_t step = 0;
+    uint16_t latency = 0;
+    int readings = 0;
+    bool usable = false;
+    TCS34725Raw raw;
+    while (!usable && readings < 10) {
+      raw = simulate(step, surfaces[i]);
+      latency += tcs34725RangingIntegrationMs(step);
+      readings++;
+      uint8_t next = tcs34725RangingNext(step, &raw, &usable);
+      if (!usable) {
+        step = next;
+      }
+    }
+    // Once usable, the step must stay put on a steady surface
+    bool stable = tcs34725RangingNext(step, &raw, &usable) == step;
+    printf("brightness %8.2f: step %u after %d readings, %3u ms to first sample, clear %5u %s\n",
+           surfaces[i], step, readings, latency, raw.c, usable && stable ? "ok" : "UNSTABLE");
+    ok &= usable && stable;
+  }
+  return ok;
+}
@@ -0,0 +1,272 @@
+/*
+ * Page renderer: every page checked against a full 1 KB framebuffer drawn
+ * pixel by pixel with the Adafruit GFX rules, and the time to compose the
+ * eight pages of a frame, with the raw icons and with the compressed ones.
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "class_descriptor.h"
+#include "page_renderer.h"
+#include "pgm_compat.h"
+#include "render_cache.h"
+#include "ita_string.h"
+
+// Same symbol names in the two headers
+namespace raw {
+#include "bitmap.h"
+#include "class_table.h"
+#define RENDER_TEXT_WIDTH(chars) PAGE_TEXT_WIDTH(chars, 2)
+static const ClassDescriptor classes[COLOR_CLASS_COUNT + 1] PROGMEM = CLASS_DESCRIPTOR_TABLE(RENDER_TEXT_WIDTH);
+}
+namespace rle {
+#include "bitmap_rle.h"
+}
+
+#define ICON_PAIR(name) {raw::epd_bitmap_##name, rle::epd_bitmap_##name, #name, \
+                         sizeof(raw::epd_bitmap_##name), sizeof(rle::epd_bitmap_##name)}
+
+static const struct {
+  const unsigned char* raw;
+  const unsigned char* rle;
+  const char* name;
+  size_t rawSize, rleSize;
+} bench_icons[] = {
+  ICON_PAIR(yellow), ICON_PAIR(red), ICON_PAIR(brown), ICON_PAIR(green),
+  ICON_PAIR(pink), ICON_PAIR(orange), ICON_PAIR(black), ICON_PAIR(azure),
+  ICON_PAIR(white), ICON_PAIR(blue), ICON_PAIR(purple), ICON_PAIR(gray),
+};
+static const size_t bench_icon_count = sizeof(bench_icons) / sizeof(bench_icons[0]);
+
+// The glyph shapes do not matter for the check, any 256 glyph font will do
+static unsigned char bench_font[256 * 5];
+
+static void framePixel(uint8_t* frame, int16_t x, int16_t y)
+{
+  if (x >= 0 && x < PAGE_SCREEN_WIDTH && y >= 0 && y < PAGE_SCREEN_HEIGHT) {
+    frame[x + (y / 8) * PAGE_SCREEN_WIDTH] |= (uint8_t)(1 << (y & 7));
+  }
+}
+
+// Adafruit_GFX drawBitmap() + print() on a framebuffer, one pixel at a time
+static void drawReference(const PageFrame* f, uint8_t* frame)
+{
+  memset(frame, 0, PAGE_SCREEN_WIDTH * PAGE_COUNT);
+  int byteWidth = (f->bmpW + 7) / 8;
+  for (int j = 0; j < (f->bitmap ? f->bmpH : 0); j++) {
+    for (int i = 0; i < f->bmpW; i++) {
+      if (f->bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7))) {
+        framePixel(frame, f->bmpX + i, f->bmpY + j);
+      }
+    }
+  }
+  int16_t x = f->textX, y = f->textY;
+  uint8_t s = f->textSize;
+  for (const char* p = f->message; *p; p++) {
+    if (*p == '\n') {
+      x = 0;
+      y += s * 8;
+      continue;
+    }
+    if (x + s * 6 > PAGE_SCREEN_WIDTH) {
+      x = 0;
+      y += s * 8;
+    }
+    unsigned char c = (unsigned char)*p;
+    if (c >= 176) {
+      c++;
+    }
+    for (int i = 0; i < 5; i++) {
+      for (int j = 0; j < 8; j++) {
+        if (f->font[c * 5 + i] & (1 << j)) {
+          for (int dx = 0; dx < s; dx++) {
+            for (int dy = 0; dy < s; dy++) {
+              framePixel(frame, x + i * s + dx, y + j * s + dy);
+            }
+          }
+        }
+      }
+    }
+    x += s * 6;
+  }
+}
+
+// drawBitmapWithText() on the paged display: panel RAM updated with the
+// pages the render cache says to send
+static void drawPanel(RenderCache* cache, uint8_t* panel, const unsigned char* bitmap, uint8_t size,
+                      const char* message)
+{
+  RenderAction action = renderCacheCheck(cache, bitmap, message);
+  if (action == RENDER_SKIP) {
+    return;
+  }
+  PageFrame f;
+  uint8_t textFirst, textLast;
+  pageLayout(&f, bitmap, size, size, message, bench_font, -1, &textFirst, &textLast);
+  renderCacheTextPages(cache, &textFirst, &textLast);
+  uint8_t first = action == RENDER_TEXT ? textFirst : 0;
+  uint8_t last = action == RENDER_TEXT ? textLast : PAGE_COUNT - 1;
+  for (uint8_t p = first; p <= last; p++) {
+    pageRender(&f, p, panel + p * PAGE_SCREEN_WIDTH);
+  }
+}
+
+// Same layout as drawBitmapWithText() on the classic display
+static PageFrame layoutFrame(const unsigned char* bitmap, uint8_t size, const char* message)
+{
+  PageFrame f;
+  uint8_t textFirst, textLast;
+  pageLayout(&f, bitmap, size, size, message, bench_font, -1, &textFirst, &textLast);
+  return f;
+}
+
+bool benchRender(const BenchOptions& options)
+{
+  printf("== paged display renderer ==\n");
+  BenchRng rng(77);
+  for (size_t i = 0; i < sizeof(bench_font); i++) {
+    bench_font[i] = (unsigned char)rng.next();
+  }
+
+  PageFrame frames[] = {
+    layoutFrame(raw::epd_bitmap_red, 40, RED_STR),
+    layoutFrame(raw::epd_bitmap_orange, 40, ORANGESTR_STR),
+    layoutFrame(raw::epd_bitmap_azure, 40, AZURE_STR),
+    layoutFrame(nullptr, 0, "?????"),
+    layoutFrame(nullptr, 0, "r: 1234, g: 5678, b: 9012"),  // wraps on three lines
+  };
+  const size_t frameCount = sizeof(frames) / sizeof(frames[0]);
+
+  bool ok = true;
+  uint8_t reference[PAGE_SCREEN_WIDTH * PAGE_COUNT];
+  uint8_t page[PAGE_SCREEN_WIDTH];
+  for (size_t i = 0; i < frameCount; i++) {
+    drawReference(&frames[i], reference);
+    for (uint8_t p = 0; p < PAGE_COUNT; p++) {
+      pageRender(&frames[i], p, page);
+      if (memcmp(page, reference + p * PAGE_SCREEN_WIDTH, PAGE_SCREEN_WIDTH) != 0) {
+        printf("FAILED: \"%s\" page %u differs from the framebuffer\n", frames[i].message, p);
+        ok = false;
+      }
+    }
+  }
+
+  // A text on two lines, then a one-line name on the same bitmap: the
+  // text-only redraw has to clear the second line too
+  RenderCache cache;
+  renderCacheReset(&cache);
+  uint8_t panel[PAGE_SCREEN_WIDTH * PAGE_COUNT];
+  static const char* const texts[] = {RED_STR ">" BLUE_STR ">" GREEN_STR, RED_STR, AZURE_STR ">" ORANGESTR_STR, "?????"};
+  bool shorterOk = true;
+  for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+    drawPanel(&cache, panel, nullptr, 0, texts[i]);
+    PageFrame f = layoutFrame(nullptr, 0, texts[i]);
+    drawReference(&f, reference);
+    shorterOk &= memcmp(panel, reference, sizeof(panel)) == 0;
+  }
+  printf("text-only redraws from two lines to one leave no stale line: %s\n", shorterOk ? "ok" : "FAILED");
+  ok &= shorterOk;
+
+  size_t count = options.samples / 100 + 1;
+  BenchTimer timer;
+  for (size_t n = 0; n < count; n++) {
+    const PageFrame* f = &frames[n % frameCount];
+    for (uint8_t p = 0; p < PAGE_COUNT; p++) {
+      pageRender(f, p, page);
+      bench_sink += page[n & (PAGE_SCREEN_WIDTH - 1)];
+    }
+  }
+  benchReport("pageRender, 8 pages per frame", count, timer.elapsedNs());
+  printf("RAM: %u byte page buffer (stack) instead of a %u byte framebuffer\n",
+         (unsigned)PAGE_SCREEN_WIDTH, (unsigned)(PAGE_SCREEN_WIDTH * PAGE_COUNT));
+
+  // Compressed icons: same pages as the raw ones, decoded while composing
+  PageFrame rawFrames[sizeof(bench_icons) / sizeof(bench_icons[0])];
+  PageFrame rleFrames[sizeof(bench_icons) / sizeof(bench_icons[0])];
+  RleDecoder decoder;
+  size_t rawBytes = 0, rleBytes = 0;
+  for (size_t i = 0; i < bench_icon_count; i++) {
+    rawFrames[i] = layoutFrame(bench_icons[i].raw, 40, bench_icons[i].name);
+    rleFrames[i] = layoutFrame(bench_icons[i].rle, 40, bench_icons[i].name);
+    rleFrames[i].rle = &decoder;
+    rawBytes += bench_icons[i].rawSize;
+    rleBytes += bench_icons[i].rleSize;
+    for (uint8_t p = 0; p < PAGE_COUNT; p++) {
+      pageRender(&rawFrames[i], p, reference);
+      pageRender(&rleFrames[i], p, page);
+      if (memcmp(page, reference, PAGE_SCREEN_WIDTH) != 0) {
+        printf("FAILED: compressed icon %s differs on page %u\n", bench_icons[i].name, p);
+        ok = false;
+      }
+    }
+    // A page in the middle of the icon alone: decoder restarted and skipped to it
+    pageRender(&rawFrames[i], 3, reference);
+    pageRender(&rleFrames[i], 3, page);
+    if (memcmp(page, reference, PAGE_SCREEN_WIDTH) != 0) {
+      printf("FAILED: compressed icon %s differs on a partial redraw\n", bench_icons[i].name);
+      ok = false;
+    }
+  }
+  printf("icons: %zu bytes of flash instead of %zu\n", rleBytes, rawBytes);
+
+  double ns[2];
+  for (int mode = 0; mode < 2; mode++) {
+    PageFrame* frames = mode ? rleFrames : rawFrames;
+    BenchTimer iconTimer;
+    for (size_t n = 0; n < count; n++) {
+      const PageFrame* f = &frames[n % bench_icon_count];
+      for (uint8_t p = 0; p < PAGE_COUNT; p++) {
+        pageRender(f, p, page);
+        bench_sink += page[n & (PAGE_SCREEN_WIDTH - 1)];
+      }
+    }
+    ns[mode] = iconTimer.elapsedNs();
+  }
+  benchReport("pageRender, raw 40x40 icons", count, ns[0]);
+  benchReport("pageRender, compressed 40x40 icons", count, ns[1]);
+
+  // Class table: the width computed at build time lays the text out
+  // exactly where measuring it does
+  static const char* const names[COLOR_CLASS_COUNT + 1] = {
+    GRAY_STR, RED_STR, YELLOW_STR, GREEN_STR, BLUE_STR, BROWN_STR,
+    ORANGESTR_STR, PURPLE_STR, PINK_STR, AZURE_STR, UNKNOWN_STR
+  };
+  bool tableOk = true;
+  for (int c = -1; c < COLOR_CLASS_COUNT; c++) {
+    ClassDescriptor d;
+    classDescriptorRead(raw::classes, (ColorClass)c, &d);
+    char name[CLASS_NAME_SIZE];
+    classNameCopy(&d, name, sizeof(name));
+    uint8_t size = d.bitmap ? 40 : 0;
+    PageFrame measured, table;
+    uint8_t mFirst, mLast, tFirst, tLast;
+    pageLayout(&measured, d.bitmap, size, size, name, bench_font, -1, &mFirst, &mLast);
+    pageLayout(&table, d.bitmap, size, size, name, bench_font, d.textWidth, &tFirst, &tLast);
+    if (strcmp(name, names[classDescriptorIndex((ColorClass)c)]) != 0 || measured.textX != table.textX ||
+        measured.textY != table.textY || mFirst != tFirst || mLast != tLast) {
+      printf("FAILED: class %d \"%s\" laid out differently from the table\n", c, name);
+      tableOk = false;
+    }
+  }
+  printf("class table: names from flash, text at the measured place: %s\n", tableOk ? "ok" : "FAILED");
+  ok &= tableOk;
+
+  for (int mode = 0; mode < 2; mode++) {
+    BenchTimer layoutTimer;
+    for (size_t n = 0; n < count; n++) {
+      ClassDescriptor d;
+      classDescriptorRead(raw::classes, (ColorClass)(n % COLOR_CLASS_COUNT), &d);
+      char name[CLASS_NAME_SIZE];
+      classNameCopy(&d, name, sizeof(name));
+      PageFrame f;
+      uint8_t first, last;
+      pageLayout(&f, d.bitmap, 40, 40, name, bench_font, mode ? d.textWidth : -1, &first, &last);
+      bench_sink += f.textX;
+    }
+    ns[mode] = layoutTimer.elapsedNs();
+  }
+  benchReport("class name + layout, text measured", count, ns[0]);
+  benchReport("class name + layout, width from table", count, ns[1]);
+  return ok;
+}
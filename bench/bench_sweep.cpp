@@ -0,0 +1,215 @@
+/*
+ * Sweep mode: debounce and time of the segments, the text of a sequence
+ * and its cut when it does not fit, and simulated sweeps across striped
+ * cables (stripes mixed at their borders under the sensor spot, sensor
+ * noise) at the sweep sample period and at a slower one, with the
+ * debounced segments and with a plain run-length of the classes.
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "color_sweep.h"
+#include "ita_string.h"
+#include "pgm_compat.h"
+
+#include "bitmap.h"
+#include "class_table.h"
+
+#define SWEEP_TEXT_WIDTH(chars) ((chars) * 12)
+static const ClassDescriptor sweep_classes[COLOR_CLASS_COUNT + 1] PROGMEM = CLASS_DESCRIPTOR_TABLE(SWEEP_TEXT_WIDTH);
+
+#define SPOT_MM 1.0               // width of the surface the sensor sees
+
+struct Stripe {
+  ColorClass colorClass;
+  double widthMm;
+};
+
+static uint8_t clampChannel(double v)
+{
+  return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)(v + 0.5));
+}
+
+static void addClasses(ColorSweep* sweep, const ColorClass* classes, size_t count, uint16_t ms)
+{
+  for (size_t i = 0; i < count; i++) {
+    colorSweepAdd(sweep, classes[i], ms);
+  }
+}
+
+// The stripes appear in this order in the segments, maybe with others between
+static bool inOrder(const std::vector<ColorClass>& truth, const std::vector<ColorClass>& found)
+{
+  size_t next = 0;
+  for (size_t i = 0; i < found.size() && next < truth.size(); i++) {
+    next += found[i] == truth[next];
+  }
+  return next == truth.size();
+}
+
+// Colored segments of a sweep, undefined gaps left out
+static std::vector<ColorClass> sweepClasses(const ColorSweep* sweep)
+{
+  std::vector<ColorClass> out;
+  for (uint8_t i = 0; i < sweep->count; i++) {
+    if (sweep->segments[i].colorClass != COL_UNDEFINED) {
+      out.push_back((ColorClass)sweep->segments[i].colorClass);
+    }
+  }
+  return out;
+}
+
+struct SweepRun {
+  uint32_t sweeps;
+  uint32_t exact;         // debounced segments equal to the stripes
+  uint32_t inOrder;       // every stripe found in order, border colors aside
+  uint32_t naiveExact;    // one segment per change of class
+  uint32_t readings;
+};
+
+// Sweeps of random cables at speeds from 50 to 200 mm/s, one reading every periodMs
+static SweepRun simulate(const RGBColor* reference, const bool* present, double periodMs, uint32_t sweeps, uint32_t seed)
+{
+  BenchRng rng(seed);
+  SweepRun run = {0, 0, 0, 0, 0};
+  for (uint32_t n = 0; n < sweeps; n++) {
+    std::vector<Stripe> stripes;
+    size_t count = 3 + rng.next() % 6;
+    while (stripes.size() < count) {
+      ColorClass c = (ColorClass)(rng.next() % COLOR_CLASS_COUNT);
+      if (!present[c] || (!stripes.empty() && stripes.back().colorClass == c)) {
+        continue;
+      }
+      Stripe s = {c, 4.0 + rng.next() % 80 / 10.0};
+      stripes.push_back(s);
+    }
+    double length = 0;
+    for (size_t i = 0; i < stripes.size(); i++) {
+      length += stripes[i].widthMm;
+    }
+    double speed = 50 + rng.next() % 151;   // mm/s
+    ColorSweep sweep;
+    colorSweepReset(&sweep);
+    std::vector<ColorClass> naive;
+    bool ended = false;
+    // From 10 mm before the cable to the sensor lifted after it
+    for (double t = 0; !ended && t < 20000; t += periodMs) {
+      double x = -10 + speed * t / 1000;
+      ColorClass observed = COL_UNDEFINED;
+      if (x > length + 5) {
+        observed = COL_UNDEFINED;   // lifted
+      } else if (x + SPOT_MM / 2 > 0 && x - SPOT_MM / 2 < length) {
+        // Average of the stripes under the spot
+        double sum[3] = {0, 0, 0}, covered = 0, start = 0;
+        for (size_t i = 0; i < stripes.size(); i++) {
+          double lo = start > x - SPOT_MM / 2 ? start : x - SPOT_MM / 2;
+          double hi = start + stripes[i].widthMm < x + SPOT_MM / 2 ? start + stripes[i].widthMm : x + SPOT_MM / 2;
+          if (hi > lo) {
+            const RGBColor& c = reference[stripes[i].colorClass];
+            sum[0] += c.r * (hi - lo);
+            sum[1] += c.g * (hi - lo);
+            sum[2] += c.b * (hi - lo);
+            covered += hi - lo;
+          }
+          start += stripes[i].widthMm;
+        }
+        if (covered > SPOT_MM / 2) {
+          RGBColor reading = {clampChannel(sum[0] / covered + rng.noise(6)), clampChannel(sum[1] / covered + rng.noise(6)),
+                              clampChannel(sum[2] / covered + rng.noise(6))};
+          observed = bestMatchRGB(reading, nullptr);
+        }
+      }
+      run.readings++;
+      colorSweepAdd(&sweep, observed, (uint16_t)(periodMs + 0.5));
+      if (observed != COL_UNDEFINED && (naive.empty() || naive.back() != observed)) {
+        naive.push_back(observed);
+      }
+      ended = colorSweepEnded(&sweep, 300);
+    }
+    std::vector<ColorClass> truth;
+    for (size_t i = 0; i < stripes.size(); i++) {
+      truth.push_back(stripes[i].colorClass);
+    }
+    run.sweeps++;
+    std::vector<ColorClass> found = sweepClasses(&sweep);
+    run.exact += ended && found == truth;
+    run.inOrder += ended && inOrder(truth, found);
+    run.naiveExact += naive == truth;
+  }
+  return run;
+}
+
+bool benchSweep(const BenchOptions& options)
+{
+  (void)options;
+  printf("== sweep mode ==\n");
+  bool ok = true;
+
+  // Two readings of another class inside a segment are part of it, and no
+  // time is lost: 5 + 2 + 4 readings of 3 ms, then a new color
+  ColorSweep sweep;
+  colorSweepReset(&sweep);
+  static const ColorClass flicker[] = {COL_UNDEFINED, COL_UNDEFINED, COL_RED, COL_RED, COL_RED, COL_RED, COL_RED,
+                                       COL_PURPLE, COL_PURPLE, COL_RED, COL_RED, COL_RED, COL_RED,
+                                       COL_BLUE, COL_BLUE, COL_BLUE, COL_BLUE, COL_UNDEFINED};
+  addClasses(&sweep, flicker, sizeof(flicker) / sizeof(flicker[0]), 3);
+  bool debounceOk = sweep.count == 2 && sweep.segments[0].colorClass == COL_RED && sweep.segments[0].ms == 11 * 3 &&
+                    sweep.segments[1].colorClass == COL_BLUE && sweep.segments[1].ms == 4 * 3 &&
+                    !colorSweepEnded(&sweep, 300);
+  static const ColorClass lifted[] = {COL_UNDEFINED};
+  for (int i = 0; i < 99; i++) {
+    addClasses(&sweep, lifted, 1, 3);
+  }
+  debounceOk &= colorSweepEnded(&sweep, 300);
+
+  char text[48];
+  colorSweepFormat(&sweep, sweep_classes, text, sizeof(text));
+  bool textOk = strcmp(text, RED_STR ">" BLUE_STR) == 0;
+  printf("flicker inside a segment absorbed, times kept, end on lift: %s; text \"%s\": %s\n",
+         debounceOk ? "ok" : "FAILED", text, textOk ? "ok" : "FAILED");
+
+  // Full buffer: the first SWEEP_MAX_SEGMENTS are kept and the text says it
+  colorSweepReset(&sweep);
+  static const ColorClass alternate[] = {COL_RED, COL_GREEN};
+  for (int segment = 0; segment < SWEEP_MAX_SEGMENTS + 4; segment++) {
+    for (int k = 0; k < SWEEP_DEBOUNCE_SAMPLES; k++) {
+      addClasses(&sweep, &alternate[segment & 1], 1, 5);
+    }
+  }
+  char shortText[16];
+  uint8_t shortLength = colorSweepFormat(&sweep, sweep_classes, shortText, sizeof(shortText));
+  bool fullOk = sweep.count == SWEEP_MAX_SEGMENTS && sweep.truncated && shortLength < sizeof(shortText) &&
+                strcmp(shortText, RED_STR ">" GREEN_STR "..") == 0;
+  printf("%u segments in %zu bytes, the rest dropped, \"%s\" in %zu bytes: %s\n", SWEEP_MAX_SEGMENTS,
+         sizeof(sweep.segments), shortText, sizeof(shortText), fullOk ? "ok" : "FAILED");
+  ok &= debounceOk && textOk && fullOk;
+
+  // One reference color per class from the table in use
+  RGBColor reference[COLOR_CLASS_COUNT];
+  bool present[COLOR_CLASS_COUNT] = {false};
+  for (size_t i = 0; i < color_reference_count; i++) {
+    ColorClass c = color_reference[i].color_class;
+    if (c < COLOR_CLASS_COUNT && !present[c] && bestMatchRGB(color_reference[i].reference_color, nullptr) == c) {
+      reference[c] = color_reference[i].reference_color;
+      present[c] = true;
+    }
+  }
+  const uint32_t sweeps = 500;
+  BenchTimer timer;
+  SweepRun fast = simulate(reference, present, 3, sweeps, 41);
+  SweepRun slow = simulate(reference, present, 25, sweeps, 41);
+  double ns = timer.elapsedNs();
+  printf("striped cables, 4-12 mm stripes at 50-200 mm/s, %u sweeps:\n", sweeps);
+  const SweepRun* runs[] = {&fast, &slow};
+  for (int i = 0; i < 2; i++) {
+    const SweepRun* r = runs[i];
+    printf("  reading every %2d ms: %5.1f%% exact, %5.1f%% all stripes in order, %5.1f%% exact without debounce\n",
+           i ? 25 : 3, 100.0 * r->exact / r->sweeps, 100.0 * r->inOrder / r->sweeps, 100.0 * r->naiveExact / r->sweeps);
+  }
+  benchReport("colorSweepAdd + bestMatchRGB", fast.readings + slow.readings, ns);
+  // Fast readings miss no stripe; the debounce removes most of the flicker
+  // at the borders, but not a mix that reads as a third class for longer
+  ok &= fast.inOrder * 10 >= fast.sweeps * 9 && fast.exact > fast.naiveExact * 4 && fast.exact > slow.exact * 2;
+  return ok;
+}
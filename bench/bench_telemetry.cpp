@@ -0,0 +1,72 @@
+/*
+ * Telemetry frames: encode/decode round trip, every single bit error
+ * caught by the CRC, encode time, and serial line time per sample against
+ * the text lines printed before.
+ */
+
+#include <string.h>
+
+#include "bench.h"
+#include "telemetry.h"
+
+bool benchTelemetry(const BenchOptions& options)
+{
+  printf("== binary telemetry ==\n");
+  std::vector<RGBColor> colors = benchJitteredSamples(color_reference, color_reference_count, options.samples, 23);
+  BenchRng rng(29);
+  bool ok = true;
+
+  std::vector<TelemetrySample> samples(colors.size());
+  for (size_t i = 0; i < samples.size(); i++) {
+    TelemetrySample& s = samples[i];
+    s.seq = (uint8_t)i;
+    s.raw[0] = (uint16_t)rng.next();
+    s.raw[1] = (uint16_t)rng.next();
+    s.raw[2] = (uint16_t)rng.next();
+    s.clear = (uint16_t)rng.next();
+    s.color = colors[i];
+    s.colorClass = bestMatchRGB(colors[i], &s.distance);
+  }
+
+  uint8_t frame[TELEMETRY_FRAME_SIZE];
+  size_t mismatches = 0, missed = 0;
+  for (size_t i = 0; i < samples.size() && i < 100000; i++) {
+    const TelemetrySample& s = samples[i];
+    TelemetrySample back;
+    telemetryEncode(&s, frame);
+    uint32_t distance = s.distance > 0xFFFF ? 0xFFFF : s.distance;
+    if (!telemetryDecode(frame, &back) || back.seq != s.seq || memcmp(back.raw, s.raw, sizeof(s.raw)) != 0 ||
+        back.clear != s.clear || back.color.r != s.color.r || back.color.g != s.color.g ||
+        back.color.b != s.color.b || back.colorClass != s.colorClass || back.distance != distance) {
+      mismatches++;
+    }
+    // Any single flipped bit must be rejected
+    for (uint8_t bit = 0; bit < TELEMETRY_FRAME_SIZE * 8; bit++) {
+      frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+      if (telemetryDecode(frame, &back)) {
+        missed++;
+      }
+      frame[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+    }
+  }
+  printf("round trip mismatches: %zu, single bit errors accepted: %zu\n", mismatches, missed);
+  ok &= mismatches == 0 && missed == 0;
+
+  BenchTimer timer;
+  for (size_t i = 0; i < samples.size(); i++) {
+    telemetryEncode(&samples[i], frame);
+    bench_sink += frame[17];
+  }
+  benchReport("telemetryEncode", samples.size(), timer.elapsedNs());
+
+  // Text output of one sample before: color line, distance and color name
+  char text[96];
+  int textBytes = snprintf(text, sizeof(text), "Red: %u  Green: %u  Blue: %u\r\n%u\r\n%s\r\n",
+                           112u, 79u, 71u, 123u, "ARANCIONE");
+  printf("serial bytes per sample: %d text, %d binary; line time %.1f ms text at 9600, %.2f ms binary at 115200\n",
+         textBytes, TELEMETRY_FRAME_SIZE, textBytes * 10 * 1000.0 / 9600, TELEMETRY_FRAME_SIZE * 10 * 1000.0 / 115200);
+  if (!ok) {
+    printf("FAILED: telemetry frames do not round trip\n");
+  }
+  return ok;
+}
@@ -0,0 +1,38 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+/*
+	Boot profiler: time since reset at the end of each init stage, up to
+	the first color on the display. The device is powered only while the
+	button is held, so this is the latency the user sees. Sent once as a
+	telemetry boot frame (telemetry.h) or printed as text.
+*/
+
+#include <stdint.h>
+
+typedef enum {
+  BOOT_SETUP,         // setup() entered: core and bootloader time
+  BOOT_CONFIG,        // per-unit record loaded
+  BOOT_SENSOR,        // sensor initialized, first integration started
+  BOOT_DISPLAY,       // display initialized and cleared
+  BOOT_FIRST_SAMPLE,  // first RGB reading available
+  BOOT_FIRST_RESULT,  // first color drawn
+  BOOT_STAGE_COUNT
+} BootStage;
+
+typedef struct {
+  uint32_t us[BOOT_STAGE_COUNT];  // micros() at the end of each stage
+  uint8_t marked;                 // one bit per stage already stamped
+} BootProfile;
+
+void bootProfileReset(BootProfile* profile);
+
+// Stamp a stage, only the first time. True when this completed the profile
+bool bootProfileMark(BootProfile* profile, BootStage stage, uint32_t nowUs);
+
+bool bootProfileComplete(const BootProfile* profile);
+
+// Short name of a stage for the text report. The string is in flash (PROGMEM)
+const char* bootStageName(BootStage stage);
+
+#endif
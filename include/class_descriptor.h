@@ -0,0 +1,42 @@
+#ifndef CLASS_DESCRIPTOR_H
+#define CLASS_DESCRIPTOR_H
+
+/*
+	What the display shows for each ColorClass: icon, name from the
+	language pack (ita_string.h, eng_string.h, spa_string.h) and the
+	width of the name in pixels with the display font. The table and the
+	names are in flash (PROGMEM) and read with pgm_read accessors; the
+	name is copied to the stack only while a frame is drawn. Fixed-width
+	fonts get the width at build time from the length of the name, so
+	drawing a class needs no text measuring.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "color_match.h"
+#include "pgm_compat.h"
+
+// textWidth of a font known only at run time (proportional U8g2 fonts)
+#define TEXT_WIDTH_MEASURE (-1)
+
+// Longest name of every language pack, terminator included
+#define CLASS_NAME_SIZE 12
+
+typedef struct {
+  const unsigned char* bitmap;  // PROGMEM icon, null for none
+  const char* name;             // PROGMEM, from the language pack
+  int16_t textWidth;            // pixels, or TEXT_WIDTH_MEASURE
+} ClassDescriptor;
+
+// Position of a class in a table of COLOR_CLASS_COUNT + 1 entries in
+// ColorClass order, COL_UNDEFINED (and anything unknown) being the last
+uint8_t classDescriptorIndex(ColorClass col);
+
+// Entry of col from a PROGMEM table
+void classDescriptorRead(const ClassDescriptor* table, ColorClass col, ClassDescriptor* out);
+
+// Name of a descriptor into buffer, always terminated
+void classNameCopy(const ClassDescriptor* descriptor, char* buffer, size_t size);
+
+#endif
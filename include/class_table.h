@@ -0,0 +1,44 @@
+#ifndef CLASS_TABLE_H
+#define CLASS_TABLE_H
+
+/*
+	Names of the language pack in flash and the descriptor table of every
+	class (class_descriptor.h). Include after a language pack and a bitmap
+	header; WIDTH(chars) gives the text width of a name on the display:
+
+	  static const ClassDescriptor table[COLOR_CLASS_COUNT + 1] PROGMEM =
+	      CLASS_DESCRIPTOR_TABLE(WIDTH);
+*/
+
+#include "class_descriptor.h"
+
+static const char class_name_gray[] PROGMEM = GRAY_STR;
+static const char class_name_red[] PROGMEM = RED_STR;
+static const char class_name_yellow[] PROGMEM = YELLOW_STR;
+static const char class_name_green[] PROGMEM = GREEN_STR;
+static const char class_name_blue[] PROGMEM = BLUE_STR;
+static const char class_name_brown[] PROGMEM = BROWN_STR;
+static const char class_name_orange[] PROGMEM = ORANGESTR_STR;
+static const char class_name_purple[] PROGMEM = PURPLE_STR;
+static const char class_name_pink[] PROGMEM = PINK_STR;
+static const char class_name_azure[] PROGMEM = AZURE_STR;
+static const char class_name_unknown[] PROGMEM = UNKNOWN_STR;
+
+#define CLASS_DESCRIPTOR(bitmap, name, WIDTH) {bitmap, name, WIDTH(sizeof(name) - 1)}
+
+// ColorClass order, COL_UNDEFINED last
+#define CLASS_DESCRIPTOR_TABLE(WIDTH) { \
+  CLASS_DESCRIPTOR(epd_bitmap_gray, class_name_gray, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_red, class_name_red, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_yellow, class_name_yellow, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_green, class_name_green, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_blue, class_name_blue, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_brown, class_name_brown, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_orange, class_name_orange, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_purple, class_name_purple, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_pink, class_name_pink, WIDTH), \
+  CLASS_DESCRIPTOR(epd_bitmap_azure, class_name_azure, WIDTH), \
+  CLASS_DESCRIPTOR(nullptr, class_name_unknown, WIDTH) \
+}
+
+#endif
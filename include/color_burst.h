@@ -0,0 +1,39 @@
+#ifndef COLOR_BURST_H
+#define COLOR_BURST_H
+
+/*
+	Burst sampling: a few back-to-back readings per answer instead of one.
+	Readings far from the per-channel median (more than COLOR_BURST_MAD_K
+	times the median absolute deviation, scaled to a standard deviation)
+	are dropped and the rest are averaged. The burst ends as soon as the
+	average is classified with COLOR_BURST_CONFIDENT, so a clear color
+	costs COLOR_BURST_MIN readings and only an ambiguous one gets up to
+	COLOR_BURST_MAX.
+*/
+
+#include "color_match.h"
+
+#define COLOR_BURST_MIN 3           // readings before the first decision
+#define COLOR_BURST_MAX 9           // readings at most per answer
+#define COLOR_BURST_CONFIDENT 128   // MatchScore.confidence that ends a burst early
+#define COLOR_BURST_MAD_K 3         // outlier beyond K standard deviations (1.5 MAD each)
+
+typedef struct {
+  RGBColor samples[COLOR_BURST_MAX];
+  uint8_t count;
+  RGBColor mean;        // robust mean of the last decided burst
+  uint8_t kept;         // readings in that mean
+  uint8_t used;         // readings taken by that burst
+} ColorBurst;
+
+void colorBurstReset(ColorBurst* burst);
+
+// One more reading. True when the burst is decided: score is filled, mean,
+// kept and used describe it, and the next reading starts a new burst
+bool colorBurstAdd(ColorBurst* burst, RGBColor sample, MatchScore* score);
+
+// Mean of the readings within the MAD limit on every channel; kept, if not
+// null, receives how many they are
+RGBColor colorBurstRobustMean(const ColorBurst* burst, uint8_t* kept);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef COLOR_FILTER_H
+#define COLOR_FILTER_H
+
+/*
+	Temporal filtering between the sensor and the classifier.
+	ColorFilter keeps the last samples in a ring buffer and gives their
+	per-channel median, which drops single spikes without lagging like a
+	long average. ClassHysteresis commits a new ColorClass only after it
+	has been seen on several consecutive samples, so a color sitting on a
+	class boundary does not flicker on the display.
+*/
+
+#include "color_match.h"
+
+#define COLOR_FILTER_SIZE 5
+// Consecutive samples of the same class needed to commit it
+#define CLASS_HYSTERESIS_SAMPLES 3
+
+typedef struct {
+  RGBColor samples[COLOR_FILTER_SIZE];
+  uint8_t head;
+  uint8_t count;
+} ColorFilter;
+
+typedef struct {
+  ColorClass committed;
+  ColorClass candidate;
+  uint8_t streak;
+  bool valid;         // false until the first class is committed
+} ClassHysteresis;
+
+// Median of count values, sorted in place (insertion sort: meant for the
+// few values of a filter window or a burst)
+uint8_t colorFilterMedianOf(uint8_t* values, uint8_t count);
+
+void colorFilterReset(ColorFilter* filter);
+void colorFilterPush(ColorFilter* filter, RGBColor color);
+// Per-channel median of the samples in the buffer (black if empty)
+RGBColor colorFilterMedian(const ColorFilter* filter);
+
+void classHysteresisReset(ClassHysteresis* hysteresis);
+// Feed one classified sample, true when the committed class changed
+bool classHysteresisUpdate(ClassHysteresis* hysteresis, ColorClass observed);
+
+#endif
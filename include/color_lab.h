@@ -0,0 +1,41 @@
+#ifndef COLOR_LAB_H
+#define COLOR_LAB_H
+
+/*
+	Perceptual matching in CIELAB with integer math only (no FPU on the
+	ATmega328 nor on the ESP32-C3). Gamma and cube root come from the
+	tables in color_lab_tables.h, L*, a*, b* are kept in 1/LAB_SCALE units.
+*/
+
+#include "color_match.h"
+
+#define LAB_SCALE 16
+
+// Max Delta E accepted as a match, compared squared in LAB_SCALE units
+#ifndef LAB_THRESHOLD_DE
+  #define LAB_THRESHOLD_DE 12
+#endif
+#define LAB_THRESHOLD ((uint32_t)LAB_THRESHOLD_DE * LAB_THRESHOLD_DE * LAB_SCALE * LAB_SCALE)
+
+typedef struct {
+  int16_t l, a, b;    // L* 0..100, a* and b* about -128..127, times LAB_SCALE
+} LabColor;
+
+// sRGB (D65) to CIELAB
+LabColor rgbToLab(RGBColor color);
+
+// Squared Delta E 76 in LAB_SCALE units
+static inline uint32_t labDistance(LabColor x, LabColor y)
+{
+  int32_t dl = (int32_t)x.l - y.l;
+  int32_t da = (int32_t)x.a - y.a;
+  int32_t db = (int32_t)x.b - y.b;
+  return (uint32_t)(dl*dl) + (uint32_t)(da*da) + (uint32_t)(db*db);
+}
+
+// Nearest reference by Delta E. labTable holds the references already
+// converted with rgbToLab(), in the same order as table
+ColorClass bestMatchLabTable(const ColoReference* table, const LabColor* labTable, size_t count,
+                             RGBColor currentColor, uint32_t* minDist);
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef COLOR_LAB_TABLES_H
+#define COLOR_LAB_TABLES_H
+
+// Generated by tools/gen_lab_tables.py, do not edit.
+
+#include "pgm_compat.h"
+
+#define LAB_M_XR 7110UL
+#define LAB_M_XG 6164UL
+#define LAB_M_XB 3110UL
+#define LAB_M_YR 3484UL
+#define LAB_M_YG 11717UL
+#define LAB_M_YB 1183UL
+#define LAB_M_ZR 291UL
+#define LAB_M_ZG 1794UL
+#define LAB_M_ZB 14299UL
+
+const uint16_t srgb_to_linear_q16[] PROGMEM = {
+      0,    20,    40,    60,    80,    99,   119,   139,   159,   179,   199,   219,
+    241,   264,   288,   313,   340,   367,   396,   427,   458,   491,   526,   562,
+    599,   637,   677,   718,   761,   805,   851,   898,   947,   997,  1048,  1101,
+   1156,  1212,  1270,  1330,  1391,  1453,  1517,  1583,  1651,  1720,  1790,  1863,
+   1937,  2013,  2090,  2170,  2250,  2333,  2418,  2504,  2592,  2681,  2773,  2866,
+   2961,  3058,  3157,  3258,  3360,  3464,  3570,  3678,  3788,  3900,  4014,  4129,
+   4247,  4366,  4488,  4611,  4736,  4864,  4993,  5124,  5257,  5392,  5530,  5669,
+   5810,  5953,  6099,  6246,  6395,  6547,  6700,  6856,  7014,  7174,  7335,  7500,
+   7666,  7834,  8004,  8177,  8352,  8528,  8708,  8889,  9072,  9258,  9445,  9635,
+   9828, 10022, 10219, 10417, 10619, 10822, 11028, 11235, 11446, 11658, 11873, 12090,
+  12309, 12530, 12754, 12980, 13209, 13440, 13673, 13909, 14146, 14387, 14629, 14874,
+  15122, 15371, 15623, 15878, 16135, 16394, 16656, 16920, 17187, 17456, 17727, 18001,
+  18277, 18556, 18837, 19121, 19407, 19696, 19987, 20281, 20577, 20876, 21177, 21481,
+  21787, 22096, 22407, 22721, 23038, 23357, 23678, 24002, 24329, 24658, 24990, 25325,
+  25662, 26001, 26344, 26688, 27036, 27386, 27739, 28094, 28452, 28813, 29176, 29542,
+  29911, 30282, 30656, 31033, 31412, 31794, 32179, 32567, 32957, 33350, 33745, 34143,
+  34544, 34948, 35355, 35764, 36176, 36591, 37008, 37429, 37852, 38278, 38706, 39138,
+  39572, 40009, 40449, 40891, 41337, 41785, 42236, 42690, 43147, 43606, 44069, 44534,
+  45002, 45473, 45947, 46423, 46903, 47385, 47871, 48359, 48850, 49344, 49841, 50341,
+  50844, 51349, 51858, 52369, 52884, 53401, 53921, 54445, 54971, 55500, 56032, 56567,
+  57105, 57646, 58190, 58737, 59287, 59840, 60396, 60955, 61517, 62082, 62650, 63221,
+  63795, 64372, 64952, 65535,
+};
+
+const uint16_t lab_f_q16[] PROGMEM = {
+   9039, 11033, 13026, 14886, 16384, 17649, 18755, 19744, 20642, 21469, 22236, 22954,
+  23629, 24268, 24875, 25454, 26008, 26538, 27049, 27541, 28016, 28475, 28920, 29352,
+  29771, 30179, 30576, 30963, 31341, 31710, 32070, 32423, 32768, 33105, 33436, 33761,
+  34080, 34392, 34699, 35001, 35298, 35589, 35876, 36159, 36437, 36711, 36981, 37247,
+  37509, 37768, 38023, 38275, 38524, 38769, 39011, 39251, 39487, 39721, 39952, 40180,
+  40406, 40629, 40850, 41068, 41284, 41498, 41710, 41920, 42127, 42333, 42536, 42738,
+  42938, 43135, 43332, 43526, 43718, 43909, 44099, 44286, 44472, 44657, 44840, 45021,
+  45202, 45380, 45557, 45733, 45908, 46081, 46253, 46424, 46593, 46761, 46928, 47094,
+  47259, 47422, 47585, 47746, 47906, 48066, 48224, 48381, 48537, 48692, 48846, 48999,
+  49151, 49302, 49453, 49602, 49751, 49898, 50045, 50191, 50336, 50480, 50624, 50766,
+  50908, 51049, 51189, 51329, 51468, 51606, 51743, 51879, 52015, 52150, 52285, 52418,
+  52551, 52684, 52816, 52947, 53077, 53207, 53336, 53464, 53592, 53720, 53846, 53972,
+  54098, 54223, 54347, 54471, 54594, 54717, 54839, 54961, 55082, 55202, 55322, 55442,
+  55561, 55679, 55797, 55915, 56032, 56148, 56264, 56380, 56495, 56609, 56723, 56837,
+  56950, 57063, 57175, 57287, 57399, 57510, 57620, 57731, 57840, 57950, 58059, 58167,
+  58275, 58383, 58490, 58597, 58704, 58810, 58916, 59021, 59126, 59231, 59335, 59439,
+  59542, 59646, 59749, 59851, 59953, 60055, 60156, 60257, 60358, 60459, 60559, 60659,
+  60758, 60857, 60956, 61054, 61153, 61250, 61348, 61445, 61542, 61639, 61735, 61831,
+  61927, 62022, 62117, 62212, 62307, 62401, 62495, 62589, 62682, 62775, 62868, 62961,
+  63053, 63145, 63237, 63328, 63419, 63510, 63601, 63692, 63782, 63872, 63962, 64051,
+  64140, 64229, 64318, 64406, 64495, 64583, 64670, 64758, 64845, 64932, 65019, 65106,
+  65192, 65278, 65364, 65450, 65535,
+};
+
+const uint16_t lab_f_low_q16[] PROGMEM = {
+   9039,  9164,  9288,  9413,  9538,  9662,  9787,  9911, 10036, 10161, 10285, 10410,
+  10534, 10659, 10784, 10908, 11033, 11157, 11282, 11407, 11531, 11656, 11780, 11905,
+  12029, 12154, 12279, 12403, 12528, 12652, 12777, 12902, 13026, 13151, 13275, 13400,
+  13525, 13649, 13770, 13890, 14008, 14124, 14238, 14350, 14460, 14569, 14676, 14782,
+  14886, 14988, 15090, 15189, 15288, 15386, 15482, 15577, 15670, 15763, 15855, 15945,
+  16035, 16124, 16211, 16298, 16384, 16469, 16553, 16636, 16718, 16800, 16881, 16961,
+  17040, 17118, 17196, 17273, 17350, 17425, 17501, 17575, 17649, 17722, 17795, 17867,
+  17938, 18009, 18079, 18149, 18219, 18287, 18356, 18423, 18491, 18557, 18624, 18689,
+  18755, 18820, 18884, 18948, 19012, 19075, 19138, 19200, 19262, 19323, 19385, 19445,
+  19506, 19566, 19625, 19685, 19744, 19802, 19860, 19918, 19976, 20033, 20090, 20147,
+  20203, 20259, 20315, 20370, 20425, 20480, 20534, 20588, 20642, 20696, 20749, 20802,
+  20855, 20908, 20960, 21012, 21064, 21115, 21166, 21217, 21268, 21319, 21369, 21419,
+  21469, 21518, 21568, 21617, 21666, 21714, 21763, 21811, 21859, 21907, 21955, 22002,
+  22049, 22096, 22143, 22190, 22236, 22282, 22328, 22374, 22420, 22465, 22511, 22556,
+  22601, 22646, 22690, 22734, 22779, 22823, 22867, 22910, 22954, 22997, 23041, 23084,
+  23127, 23169, 23212, 23254, 23297, 23339, 23381, 23423, 23464, 23506, 23547, 23588,
+  23629, 23670, 23711, 23752, 23792, 23833, 23873, 23913, 23953, 23993, 24033, 24072,
+  24112, 24151, 24190, 24229, 24268, 24307, 24346, 24385, 24423, 24461, 24500, 24538,
+  24576, 24613, 24651, 24689, 24726, 24764, 24801, 24838, 24875, 24912, 24949, 24986,
+  25023, 25059, 25096, 25132, 25168, 25204, 25240, 25276, 25312, 25348, 25383, 25419,
+  25454, 25489, 25525, 25560, 25595, 25630, 25664, 25699, 25734, 25768, 25803, 25837,
+  25871, 25906, 25940, 25974, 26008,
+};
+
+#endif
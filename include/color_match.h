@@ -0,0 +1,139 @@
+#ifndef COLOR_MATCH_H
+#define COLOR_MATCH_H
+
+/*
+	Color classification core.
+	Everything in here is plain C/C++ without Arduino headers, so the same
+	code runs on the boards and in the host (native) build used for the
+	benchmarks.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "pgm_compat.h"
+
+// Use the precomputed RGB cube (tools/gen_color_lut.py) instead of the linear scan
+//#define COLOR_MATCH_LUT
+
+// Use the table and per-class thresholds learned from recorded samples
+// (tools/calibrate.py writes include/color_calibration.h)
+//#define COLOR_MATCH_CALIBRATED
+
+// Match with the CIELAB distance (Delta E 76, color_lab.h) instead of the RGB one
+//#define COLOR_MATCH_LAB
+
+// Bits per channel of the RGB cube: 4 = about 4.7 KB, 5 = about 33 KB of flash
+#ifndef COLOR_LUT_BITS
+  #ifdef __AVR__
+    #define COLOR_LUT_BITS 4
+  #else
+    #define COLOR_LUT_BITS 5
+  #endif
+#endif
+
+typedef struct {
+  uint8_t r, g, b;
+} RGBColor;
+
+typedef enum {
+    COL_UNDEFINED = -1,
+    COL_GRAY,
+    COL_RED,
+    COL_YELLOW,
+    COL_GREEN,
+    COL_BLUE,
+    COL_BROWN,
+    COL_ORANGE,
+    COL_PURPLE,
+    COL_PINK,
+    COL_AZURE
+} ColorClass;
+
+#define COLOR_CLASS_COUNT 10
+
+typedef struct {
+  RGBColor reference_color;
+  ColorClass color_class;
+} ColoReference;
+
+// Max squared distance accepted as a match
+#define THRESHOLD 700
+
+// Reference tables, one per sensor/board combination
+extern const ColoReference color_reference_nano[];
+extern const size_t color_reference_nano_count;
+extern const ColoReference color_reference_esp32c3[];
+extern const size_t color_reference_esp32c3_count;
+
+// Table used by bestMatchRGB() on the current target
+extern const ColoReference* const color_reference;
+extern const size_t color_reference_count;
+
+// Nearest reference of the given table (squared RGB distance, THRESHOLD applied).
+// minDist, if not null, receives the best distance (0xFFFFFFFF when nothing matched)
+ColorClass bestMatchRGBTable(const ColoReference* table, size_t count, RGBColor currentColor, uint32_t* minDist);
+// Same, with the max squared distance of each ColorClass instead of THRESHOLD
+ColorClass bestMatchRGBTableThresholds(const ColoReference* table, size_t count, const uint16_t* thresholds,
+                                       RGBColor currentColor, uint32_t* minDist);
+ColorClass bestMatchRGB(RGBColor currentColor, uint32_t* minDist = nullptr);
+
+typedef struct {
+  ColorClass best;        // what bestMatchRGB() returns
+  ColorClass second;      // nearest other class, within its limit or not
+  uint32_t bestDist;      // 0xFFFFFFFF when nothing matched
+  uint32_t secondDist;
+  uint8_t confidence;     // 0 = on a boundary .. 255 = on the reference
+} MatchScore;
+
+// bestMatchRGB() plus the runner-up and how clear the choice was: the
+// smaller of the margins to the second class and to the match limit. When
+// nothing matched, second is the nearest class and confidence is how far
+// outside its limit the color is. Scans the table under COLOR_MATCH_LUT too
+void bestMatchRGBScore(RGBColor currentColor, MatchScore* score);
+
+// Table for bestMatchRGB() loaded at run time (device_config.h), thresholds
+// per ColorClass or nullptr for THRESHOLD. Kept by pointer, not copied;
+// a null table goes back to the built-in one.
+// False when the matcher cannot use it: COLOR_MATCH_LUT is built from the
+// built-in table, COLOR_MATCH_LAB caches at most color_reference_count entries
+bool colorMatchSetTable(const ColoReference* table, size_t count, const uint16_t* thresholds);
+
+// RGB cube from color_lut.h (tools/gen_color_lut.py), all in PROGMEM.
+// A cell is 0 for undefined, n for ColorClass n-1, or COLOR_LUT_LISTS + l
+// when the answer changes inside it: list l then names the only references
+// (table indices, in table order) that can be the nearest one there
+#define COLOR_LUT_LISTS 16
+
+typedef struct {
+  const uint8_t* cells;       // one byte per cell, r major
+  const uint16_t* starts;     // list l is lists[starts[l]] .. lists[starts[l + 1] - 1]
+  const uint8_t* lists;
+  uint8_t bits;               // per channel
+} ColorLut;
+
+// Cell of the cube for a color
+static inline uint8_t colorLutCell(const ColorLut* lut, RGBColor currentColor)
+{
+  uint8_t bits = lut->bits;
+  uint8_t shift = 8 - bits;
+  uint16_t index = ((uint16_t)(currentColor.r >> shift) << (2 * bits))
+                 | ((uint16_t)(currentColor.g >> shift) << bits)
+                 | (currentColor.b >> shift);
+  return pgm_read_byte(lut->cells + index);
+}
+
+// Classification with a cube built from table: one read for most colors,
+// a scan of the 1-3 references of its list for the others. Always the
+// class of bestMatchRGBTable(). minDist is exact for a list, 0 when the
+// cell decides (0xFFFFFFFF when undefined)
+ColorClass bestMatchRGBLut(const ColorLut* lut, const ColoReference* table, RGBColor currentColor,
+                           uint32_t* minDist = nullptr);
+
+// TCS3200: pulse width to 0-255 with the white/black calibration values
+uint8_t tcs3200RawToChannel(int raw, int rawMin, int rawMax);
+
+// TCS34725: raw counts to 0-255 like Adafruit_TCS34725::getRGB(), integer math only
+RGBColor tcs34725RawToRGB(uint16_t r, uint16_t g, uint16_t b, uint16_t c);
+
+#endif
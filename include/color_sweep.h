@@ -0,0 +1,56 @@
+#ifndef COLOR_SWEEP_H
+#define COLOR_SWEEP_H
+
+/*
+	Sweep mode (SWEEP_MODE in main.cpp): the sensor is moved across a
+	striped cable, a wiring loom or a fabric, and every fast reading is
+	run-length encoded into (class, duration) segments. A new class
+	starts a segment only after SWEEP_DEBOUNCE_SAMPLES consecutive
+	readings; shorter runs (a mix of two stripes at their border, a spike)
+	are added to the segment they interrupt. Readings of no class before
+	the first color are ignored, and the sweep is over once nothing but
+	COL_UNDEFINED has been read for a while (sensor lifted).
+	Fixed buffer, no allocation: SWEEP_MAX_SEGMENTS segments, 3 bytes each
+	on the AVR; further segments are dropped and the text ends with "..".
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "class_descriptor.h"
+#include "color_match.h"
+
+#define SWEEP_MAX_SEGMENTS 16
+#define SWEEP_DEBOUNCE_SAMPLES 3
+#define SWEEP_SEPARATOR '>'       // in the classic GFX and U8g2 fonts alike
+
+typedef struct {
+  int8_t colorClass;              // ColorClass, COL_UNDEFINED is -1
+  uint16_t ms;                    // saturates at 65535
+} SweepSegment;
+
+typedef struct {
+  SweepSegment segments[SWEEP_MAX_SEGMENTS];
+  uint8_t count;
+  bool truncated;                 // segments dropped with the buffer full
+  ColorClass candidate;           // class of the run not committed yet
+  uint8_t streak;                 // its readings so far
+  uint16_t candidateMs;           // and their time
+  uint16_t undefinedMs;           // time of COL_UNDEFINED readings in a row
+} ColorSweep;
+
+void colorSweepReset(ColorSweep* sweep);
+
+// One classified reading and the time since the previous one. True when
+// it started a new segment
+bool colorSweepAdd(ColorSweep* sweep, ColorClass observed, uint16_t elapsedMs);
+
+// A color was seen, then only COL_UNDEFINED for at least idleMs
+bool colorSweepEnded(const ColorSweep* sweep, uint16_t idleMs);
+
+// Names of the colored segments from a PROGMEM descriptor table, joined by
+// SWEEP_SEPARATOR ("ROSSO>BLU>VERDE"); cut at a name boundary with ".."
+// when it does not fit. Length of the text
+uint8_t colorSweepFormat(const ColorSweep* sweep, const ClassDescriptor* table, char* out, uint8_t size);
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef DEVICE_CONFIG_H
+#define DEVICE_CONFIG_H
+
+/*
+	Per-unit settings kept out of the firmware image: TCS3200 white/black
+	calibration, TCS34725 gain, reference table and per-class thresholds.
+	They are stored as one fixed size record with a version and a CRC, in
+	EEPROM on AVR, in NVS (Preferences) on ESP32 and in a file on the host.
+	setup() loads the record once; a missing, damaged or older record
+	leaves the built-in defaults.
+
+	Record, multi-byte fields little endian:
+	  0     magic 0xCB
+	  1     DEVICE_CONFIG_VERSION
+	  2..7  TCS3200 pulse width on white, red/green/blue (int16, us)
+	  8..13 TCS3200 pulse width on black, red/green/blue (int16, us)
+	  14    TCS34725 gain (0 = 1x, 1 = 4x, 2 = 16x, 3 = 60x)
+	  15    reference count, 0 = built-in color_reference[]
+	  16..  DEVICE_CONFIG_MAX_REFERENCES x r, g, b, ColorClass (int8)
+	  ..    COLOR_CLASS_COUNT x max squared distance (uint16)
+	  last 2 CRC-16/CCITT of all the bytes before it
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "color_match.h"
+
+#define DEVICE_CONFIG_MAGIC 0xCB
+#define DEVICE_CONFIG_VERSION 1
+#define DEVICE_CONFIG_MAX_REFERENCES 24
+#define DEVICE_CONFIG_RECORD_SIZE (16 + 4 * DEVICE_CONFIG_MAX_REFERENCES + 2 * COLOR_CLASS_COUNT + 2)
+
+// Gain used when nothing is stored, same as the old tcs.setGain(TCS34725_GAIN_16X)
+#define DEVICE_CONFIG_DEFAULT_GAIN 2
+
+typedef struct {
+  int16_t tcs3200Min[3];    // pulse width on a white surface (maps to 255)
+  int16_t tcs3200Max[3];    // pulse width on a black surface (maps to 0)
+  uint8_t tcs34725Gain;
+  uint8_t referenceCount;
+  ColoReference references[DEVICE_CONFIG_MAX_REFERENCES];
+  uint16_t thresholds[COLOR_CLASS_COUNT];
+} DeviceConfig;
+
+// Built-in values: no TCS3200 calibration, 16x gain, built-in table at THRESHOLD
+void deviceConfigDefaults(DeviceConfig* config);
+
+void deviceConfigEncode(const DeviceConfig* config, uint8_t* record);
+// False on a bad magic, version, count or CRC; config is not touched then
+bool deviceConfigDecode(const uint8_t* record, DeviceConfig* config);
+
+// Highest gain that keeps a white surface below the ranging band
+// (TCS34725_RANGING_HIGH_PCT of fullScale), from its clear count at each gain
+uint8_t deviceConfigPickGain(const uint16_t clearAtGain[4], uint16_t fullScale);
+
+// Storage of the target. Load fills config with the defaults first and
+// returns true only when a valid record replaced them
+bool deviceConfigLoad(DeviceConfig* config);
+bool deviceConfigSave(const DeviceConfig* config);
+
+#ifndef ARDUINO
+// Host build: the record lives in this file (default "device_config.bin")
+void deviceConfigSetPath(const char* path);
+#endif
+
+#endif
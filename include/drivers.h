@@ -0,0 +1,131 @@
+#ifndef DRIVERS_H
+#define DRIVERS_H
+
+/*
+	Sensor and display drivers as compile-time policies. main.cpp picks one
+	Sensor<> and one Display<> from the build flags (SensorDriver and
+	DisplayDriver) and calls their static functions directly: no virtual
+	calls, no function pointers, and the code of the drivers that are not
+	selected is never compiled in.
+
+	Sensor<Chip>:
+		static void begin();              first integration started
+		static bool read(RGBColor* c);    false while nothing new is ready
+		static void sleep();              powered down between samples
+		static void wake();
+
+	Display<Panel>:
+		static void begin();
+		static uint16_t draw(bitmap, w, h, text, textWidth, action);
+		                                  bitmap (may be null) and centered
+		                                  text, returns the bytes flushed;
+		                                  textWidth TEXT_WIDTH_MEASURE when
+		                                  not known in advance
+		static constexpr int16_t nameWidth(uint8_t chars);
+		                                  width of a one-line name at build
+		                                  time, TEXT_WIDTH_MEASURE for
+		                                  proportional fonts
+		static void drawRGB(RGBColor c);  raw values (TEST_SENSOR)
+
+	The hardware ones (Tcs34725, Tcs3200, U8g2Oled042, Ssd1306,
+	Ssd1306Paged) are specialized in main.cpp next to the device objects.
+	MockSensor and MockDisplay are portable, for the host build.
+*/
+
+#include <stdint.h>
+
+#include "class_descriptor.h"
+#include "color_match.h"
+#include "render_cache.h"
+#include "sample_pipeline.h"
+
+// Sensor chips
+struct Tcs34725 {};
+struct Tcs3200 {};
+struct MockSensor {};
+
+// Displays
+struct U8g2Oled042 {};      // 0.42" 72x40 window of a 128x64 U8g2 buffer (ESP32-C3)
+struct Ssd1306 {};          // Adafruit_SSD1306 with its 1 KB framebuffer
+struct Ssd1306Paged {};     // no framebuffer, one page at a time (ssd1306_paged.h)
+struct MockDisplay {};
+
+// Only the specializations exist: an unknown policy does not compile
+template <typename Chip> struct Sensor;
+template <typename Panel> struct Display;
+
+// Plays a table of readings in a loop, every call has one ready
+template <> struct Sensor<MockSensor> {
+  static const RGBColor* samples;
+  static uint16_t count;
+  static uint16_t next;
+
+  static void load(const RGBColor* table, uint16_t tableCount) {
+    samples = table;
+    count = tableCount;
+    next = 0;
+  }
+  static void begin() {
+    next = 0;
+  }
+  static bool read(RGBColor* color) {
+    if (count == 0) {
+      return false;
+    }
+    *color = samples[next];
+    next = next + 1 == count ? 0 : next + 1;
+    return true;
+  }
+  static void sleep() {}
+  static void wake() {}
+};
+
+// Remembers the last frame instead of drawing it
+template <> struct Display<MockDisplay> {
+  static const unsigned char* bitmap;
+  static char text[24];
+  static uint32_t frames;
+
+  static void begin() {
+    bitmap = nullptr;
+    text[0] = '\0';
+    frames = 0;
+  }
+  static constexpr int16_t nameWidth(uint8_t chars) {
+    return chars * 6;
+  }
+  static uint16_t draw(const unsigned char* bmp, uint8_t width, uint8_t height, const char* message, int16_t textWidth,
+                       RenderAction action) {
+    (void)width;
+    (void)height;
+    (void)textWidth;
+    (void)action;
+    bitmap = bmp;
+    uint8_t i = 0;
+    for (; message[i] && i < sizeof(text) - 1; i++) {
+      text[i] = message[i];
+    }
+    text[i] = '\0';
+    frames++;
+    return 0;
+  }
+  static void drawRGB(RGBColor color) {
+    (void)color;
+    frames++;
+  }
+};
+
+// One reading through the pipeline: false while the sensor has nothing
+// new (integration running, capture not complete)
+template <typename SensorDriver>
+inline bool scanStep(SamplePipeline* pipeline, PipelineResult* result)
+{
+  RGBColor color;
+  if (!SensorDriver::read(&color)) {
+    return false;
+  }
+  samplePipelineRun(pipeline, color, result);
+  return true;
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef ENG_STRING_H
+#define ENG_STRING_H
+
+/*
+	English language pack (-DLANGUAGE_EN), same names as ita_string.h.
+*/
+
+#define BROWN_STR       "BROWN"
+#define BLACK_STR       "BLACK"
+#define WHITE_STR       "WHITE"
+#define GREEN_STR       "GREEN"
+#define BLUE_STR        "BLUE"
+#define AZURE_STR       "AZURE"
+#define RED_STR         "RED"
+#define PINK_STR        "PINK"
+#define PURPLE_STR      "PURPLE"
+#define ORANGESTR_STR   "ORANGE"
+#define GRAY_STR        "GRAY"
+#define YELLOW_STR      "YELLOW"
+#define UNKNOWN_STR     "?????"
+
+#endif
@@ -1,6 +1,12 @@
 #ifndef ITA_STRING_H
 #define ITA_STRING_H
 
+/*
+	Italian language pack (default). Every pack defines the same names;
+	select another one with -DLANGUAGE_EN or -DLANGUAGE_ES. main.cpp puts
+	them in flash (class_descriptor.h).
+*/
+
 #define BROWN_STR       "MARRONE"
 #define BLACK_STR       "NERO"
 #define WHITE_STR       "BIANCO"
@@ -13,5 +19,6 @@
 #define ORANGESTR_STR   "ARANCIONE"
 #define GRAY_STR        "GRIGIO"
 #define YELLOW_STR      "GIALLO"
+#define UNKNOWN_STR     "?????"
 
-#endif
\ No newline at end of file
+#endif
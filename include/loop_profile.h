@@ -0,0 +1,76 @@
+#ifndef LOOP_PROFILE_H
+#define LOOP_PROFILE_H
+
+/*
+	Loop profiler (LOOP_PROFILE in main.cpp): where the time of loop()
+	goes, stage by stage. main.cpp stamps a lap at the end of each piece
+	of work: the time since the previous lap goes into the histogram of
+	the stage that just ran. LOOP_CYCLE is the time from one classified
+	reading to the next, the cadence the user sees.
+
+	Histograms are log2: bin b counts the durations of b significant bits,
+	[2^(b-1), 2^b) ticks, bin 0 the zero ones, the last bin everything
+	longer. Counts stop at 65535. Ticks are micros() on the AVR (4 us
+	steps) and CPU cycles on the ESP32 (ticksPerUs converts).
+	The serial command 'L' prints them and starts over.
+*/
+
+#include <stdint.h>
+
+#ifndef LOOP_PROFILE_BINS
+  #ifdef __AVR__
+    #define LOOP_PROFILE_BINS 21    // micros(): last bin from 1 s
+  #else
+    #define LOOP_PROFILE_BINS 29    // 160 MHz cycles: last bin from 1.7 s
+  #endif
+#endif
+
+typedef enum {
+  LOOP_SENSOR,   // reading or polling the sensor, integration included when blocking
+  LOOP_MATCH,    // filter and classification of a reading (bestMatchRGB())
+  LOOP_RENDER,   // icon and text into the display buffer
+  LOOP_FLUSH,    // display transfer on I2C (paged SSD1306: rendering included)
+  LOOP_SERIAL,   // text log and telemetry frames
+  LOOP_WAIT,     // pause between samples, waiting for an integration
+  LOOP_OTHER,    // serial commands and anything between two laps
+  LOOP_CYCLE,    // one classified reading to the next
+  LOOP_STAGE_COUNT
+} LoopStage;
+
+typedef struct {
+  uint16_t bins[LOOP_STAGE_COUNT][LOOP_PROFILE_BINS];
+  uint32_t maxTicks[LOOP_STAGE_COUNT];
+  uint32_t lapStart;        // ticks at the last lap
+  uint32_t cycleStart;      // ticks at the last reading, 0: none yet
+  uint16_t ticksPerUs;
+} LoopProfile;
+
+void loopProfileReset(LoopProfile* profile, uint16_t ticksPerUs, uint32_t now);
+
+// One duration into the histogram of a stage
+void loopProfileAdd(LoopProfile* profile, LoopStage stage, uint32_t ticks);
+
+// Time since the previous lap into stage
+void loopProfileLap(LoopProfile* profile, LoopStage stage, uint32_t now);
+
+// A classified reading: time since the previous one into LOOP_CYCLE
+void loopProfileReading(LoopProfile* profile, uint32_t now);
+
+uint8_t loopProfileBin(uint32_t ticks);
+
+// Longest duration counted in bin, in ticks (the last bin has no end)
+uint32_t loopProfileBinTop(uint8_t bin);
+
+uint32_t loopProfileCount(const LoopProfile* profile, LoopStage stage);
+
+// Top of the bin holding the given percentile of a stage, in ticks
+uint32_t loopProfilePercentile(const LoopProfile* profile, LoopStage stage, uint8_t percent);
+
+// Short name of a stage for the text report. The string is in flash (PROGMEM)
+const char* loopStageName(LoopStage stage);
+
+// Device side (ARDUINO only): micros() on the AVR, cycle counter on the ESP32
+uint32_t loopProfileNow();
+uint16_t loopProfileTicksPerUs();
+
+#endif
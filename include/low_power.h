@@ -0,0 +1,31 @@
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+/*
+	CPU sleep between samples (LOW_POWER).
+	AVR: power-down, woken by the watchdog in steps of 16 ms to 8 s, or
+	earlier by a LOW level on the wake pin (INT0/INT1: D2 or D3); what is
+	left under 16 ms is spent in idle mode. millis() does not advance in
+	power-down.
+	ESP32: light sleep with a timer wakeup and optionally a GPIO one; RAM
+	and peripherals are kept.
+*/
+
+#include <stdint.h>
+
+// CPU asleep and sensor powered down between samples. Here rather than in
+// main.cpp: low_power.cpp builds nothing without it, not even the watchdog
+// interrupt vector
+//#define LOW_POWER
+
+// Sleep about ms milliseconds; wakePin < 0 means timer only.
+// Returns early when wakePin goes LOW (sensor INT, open drain).
+// Returns the milliseconds spent in power-down, which millis() missed:
+// nominal watchdog periods, a period cut short by the wake pin counted
+// whole. 0 on the ESP32, where millis() keeps running
+uint16_t lowPowerSleepMs(uint16_t ms, int8_t wakePin);
+
+// Until the next interrupt: at most one Timer0 tick (1 ms) on AVR
+void lowPowerIdle();
+
+#endif
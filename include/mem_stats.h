@@ -0,0 +1,37 @@
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+/*
+	RAM headroom of the running firmware (MEM_STATS in main.cpp).
+	AVR: memStatsBegin(), first thing in setup(), paints the RAM between
+	the heap and the stack pointer with MEM_PAINT. The stack high-water
+	mark is the lowest byte the paint no longer covers; what is still
+	painted above the heap was never used and is the real margin.
+	ESP32: FreeRTOS high-water mark of the loop() task stack and the free
+	heap now and at its lowest.
+	The serial command 'M' prints them, or sends a telemetry memory frame
+	(telemetry.h).
+*/
+
+#include <stdint.h>
+
+#define MEM_PAINT 0xC5
+
+typedef struct {
+  uint32_t freeRam;     // AVR: between heap and stack pointer now. ESP32: free heap
+  uint32_t stackFree;   // stack never used since boot (AVR: painted bytes left above the heap)
+  uint32_t stackPeak;   // deepest stack since boot, bytes
+  uint32_t heapBreak;   // AVR: top of the heap (address). ESP32: lowest free heap since boot
+} MemStats;
+
+// Fill [low, high) with MEM_PAINT
+void memPaint(uint8_t* low, uint8_t* high);
+
+// Painted bytes from low up to the first overwritten one, at most high - low
+uint32_t memPaintedBytes(const uint8_t* low, const uint8_t* high);
+
+// Device side, see above (ARDUINO only)
+void memStatsBegin();
+void memStatsRead(MemStats* stats);
+
+#endif
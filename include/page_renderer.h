@@ -0,0 +1,48 @@
+#ifndef PAGE_RENDERER_H
+#define PAGE_RENDERER_H
+
+/*
+	Frame composition one SSD1306 page (8 pixel rows, 128 bytes) at a time,
+	so the 1 KB framebuffer is not needed. Bitmap and text follow the
+	Adafruit GFX rules (drawBitmap() format, classic 5x7 font, text size,
+	wrapping at the right edge), so a page is byte-for-byte what
+	Adafruit_SSD1306 would have sent for the same drawing calls.
+*/
+
+#include <stdint.h>
+
+#include "rle_decoder.h"
+
+#define PAGE_SCREEN_WIDTH 128
+#define PAGE_SCREEN_HEIGHT 64
+#define PAGE_COUNT (PAGE_SCREEN_HEIGHT / 8)
+
+typedef struct {
+  const unsigned char* bitmap;  // PROGMEM, (w+7)/8 bytes per row, MSB first; may be null
+  RleDecoder* rle;              // not null: bitmap is a compressed icon (rle_decoder.h)
+  int16_t bmpX, bmpY;
+  uint8_t bmpW, bmpH;
+  const char* message;          // RAM string, may be null
+  int16_t textX, textY;
+  uint8_t textSize;
+  const unsigned char* font;    // PROGMEM classic GFX font, 5 bytes per glyph
+} PageFrame;
+
+// Size of message drawn from (0, 0), same result as Adafruit_GFX::getTextBounds()
+void pageTextBounds(const char* message, uint8_t textSize, uint16_t* w, uint16_t* h);
+
+// Width of a single line of chars characters, known at build time
+#define PAGE_TEXT_WIDTH(chars, textSize) ((chars) * (textSize) * 6)
+
+// Layout of drawBitmapWithText(): bitmap centered at the top, text of size 2
+// centered in the space below it. textWidth is the width of a one-line
+// message (PAGE_TEXT_WIDTH), negative to measure it here. textFirst..textLast
+// are the pages the text covers
+void pageLayout(PageFrame* frame, const unsigned char* bitmap, uint8_t bmpW, uint8_t bmpH,
+                const char* message, const unsigned char* font, int16_t textWidth,
+                uint8_t* textFirst, uint8_t* textLast);
+
+// Pixels of page (rows page*8 .. page*8+7) into out[PAGE_SCREEN_WIDTH], bit 0 = top row
+void pageRender(const PageFrame* frame, uint8_t page, uint8_t* out);
+
+#endif
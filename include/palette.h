@@ -0,0 +1,47 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+/*
+	Large named-color palettes (CSS/X11 names, per-shade references).
+	The entries are stored in flash in k-d tree order, as produced offline by
+	tools/gen_palette.py: the median of every range [lo, hi) is the split
+	node, the split axis cycles r, g, b with the depth. No pointers are
+	stored, the tree is implicit in the order of the array.
+*/
+
+#include "color_match.h"
+
+// Use a palette index instead of the color_reference[] classes
+//#define COLOR_MATCH_PALETTE
+
+typedef struct {
+  uint8_t r, g, b;
+  uint16_t name;      // offset of the name in Palette::names
+} PaletteEntry;
+
+typedef struct {
+  const PaletteEntry* entries;  // PROGMEM, k-d tree order
+  uint16_t count;
+  const char* names;            // PROGMEM, NUL separated names
+} Palette;
+
+#define PALETTE_NO_MATCH -1
+
+// Max squared distance for a palette match, by default always the nearest name
+#ifndef PALETTE_THRESHOLD
+  #define PALETTE_THRESHOLD 0xFFFFFFFF
+#endif
+
+// Nearest palette entry within threshold (squared RGB distance), or PALETTE_NO_MATCH.
+// minDist, if not null, receives the best distance found
+int16_t paletteNearest(const Palette* palette, RGBColor currentColor, uint32_t threshold, uint32_t* minDist);
+
+// Copy the name of an entry from flash into buffer (always NUL terminated)
+void paletteName(const Palette* palette, int16_t index, char* buffer, size_t size);
+
+#ifdef PALETTE_COUNT_VISITS
+// Nodes looked at by paletteNearest(), for the host benchmark
+extern uint32_t palette_visits;
+#endif
+
+#endif
@@ -0,0 +1,294 @@
+#ifndef PALETTE_CSS_H
+#define PALETTE_CSS_H
+
+// Generated by tools/gen_palette.py from palette_css.csv, do not edit.
+// 139 entries in k-d tree order.
+
+#include "palette.h"
+
+const char palette_css_names[] PROGMEM =
+  "black\0"
+  "darkslategray\0"
+  "midnightblue\0"
+  "navy\0"
+  "darkgreen\0"
+  "green\0"
+  "darkolivegreen\0"
+  "teal\0"
+  "dimgray\0"
+  "maroon\0"
+  "darkred\0"
+  "firebrick\0"
+  "purple\0"
+  "brown\0"
+  "olive\0"
+  "saddlebrown\0"
+  "sienna\0"
+  "gray\0"
+  "darkblue\0"
+  "indigo\0"
+  "mediumblue\0"
+  "blue\0"
+  "rebeccapurple\0"
+  "darkslateblue\0"
+  "steelblue\0"
+  "royalblue\0"
+  "slateblue\0"
+  "darkmagenta\0"
+  "darkviolet\0"
+  "blueviolet\0"
+  "darkorchid\0"
+  "slategray\0"
+  "mediumpurple\0"
+  "mediumslateblue\0"
+  "lightslategray\0"
+  "forestgreen\0"
+  "seagreen\0"
+  "mediumseagreen\0"
+  "darkcyan\0"
+  "limegreen\0"
+  "lime\0"
+  "springgreen\0"
+  "mediumspringgreen\0"
+  "cadetblue\0"
+  "olivedrab\0"
+  "yellowgreen\0"
+  "darkseagreen\0"
+  "lightgreen\0"
+  "palegreen\0"
+  "lawngreen\0"
+  "chartreuse\0"
+  "greenyellow\0"
+  "darkgray\0"
+  "lightseagreen\0"
+  "cornflowerblue\0"
+  "dodgerblue\0"
+  "deepskyblue\0"
+  "darkturquoise\0"
+  "mediumturquoise\0"
+  "turquoise\0"
+  "aqua\0"
+  "mediumaquamarine\0"
+  "lightsteelblue\0"
+  "skyblue\0"
+  "lightskyblue\0"
+  "lightblue\0"
+  "aquamarine\0"
+  "powderblue\0"
+  "paleturquoise\0"
+  "darkgoldenrod\0"
+  "chocolate\0"
+  "crimson\0"
+  "indianred\0"
+  "lightcoral\0"
+  "peru\0"
+  "goldenrod\0"
+  "darkkhaki\0"
+  "darksalmon\0"
+  "sandybrown\0"
+  "red\0"
+  "orangered\0"
+  "tomato\0"
+  "coral\0"
+  "salmon\0"
+  "darkorange\0"
+  "orange\0"
+  "lightsalmon\0"
+  "mediumvioletred\0"
+  "rosybrown\0"
+  "palevioletred\0"
+  "mediumorchid\0"
+  "orchid\0"
+  "tan\0"
+  "silver\0"
+  "lightgray\0"
+  "thistle\0"
+  "plum\0"
+  "deeppink\0"
+  "hotpink\0"
+  "fuchsia\0"
+  "violet\0"
+  "burlywood\0"
+  "lightpink\0"
+  "pink\0"
+  "gold\0"
+  "palegoldenrod\0"
+  "khaki\0"
+  "wheat\0"
+  "gainsboro\0"
+  "antiquewhite\0"
+  "yellow\0"
+  "lightgoldenrodyellow\0"
+  "beige\0"
+  "navajowhite\0"
+  "moccasin\0"
+  "peachpuff\0"
+  "bisque\0"
+  "blanchedalmond\0"
+  "papayawhip\0"
+  "lemonchiffon\0"
+  "cornsilk\0"
+  "lightyellow\0"
+  "mistyrose\0"
+  "lavender\0"
+  "whitesmoke\0"
+  "aliceblue\0"
+  "ghostwhite\0"
+  "lightcyan\0"
+  "honeydew\0"
+  "mintcream\0"
+  "azure\0"
+  "linen\0"
+  "oldlace\0"
+  "seashell\0"
+  "lavenderblush\0"
+  "floralwhite\0"
+  "ivory\0"
+  "snow\0"
+  "white\0";
+
+const PaletteEntry palette_css_entries[] PROGMEM = {
+  {  0,   0,   0,     0},  // black
+  { 47,  79,  79,     6},  // darkslategray
+  { 25,  25, 112,    20},  // midnightblue
+  {  0,   0, 128,    33},  // navy
+  {  0, 100,   0,    38},  // darkgreen
+  {  0, 128,   0,    48},  // green
+  { 85, 107,  47,    54},  // darkolivegreen
+  {  0, 128, 128,    69},  // teal
+  {105, 105, 105,    74},  // dimgray
+  {128,   0,   0,    82},  // maroon
+  {139,   0,   0,    89},  // darkred
+  {178,  34,  34,    97},  // firebrick
+  {128,   0, 128,   107},  // purple
+  {165,  42,  42,   114},  // brown
+  {128, 128,   0,   120},  // olive
+  {139,  69,  19,   126},  // saddlebrown
+  {160,  82,  45,   138},  // sienna
+  {128, 128, 128,   145},  // gray
+  {  0,   0, 139,   150},  // darkblue
+  { 75,   0, 130,   159},  // indigo
+  {  0,   0, 205,   166},  // mediumblue
+  {  0,   0, 255,   177},  // blue
+  {102,  51, 153,   182},  // rebeccapurple
+  { 72,  61, 139,   196},  // darkslateblue
+  { 70, 130, 180,   210},  // steelblue
+  { 65, 105, 225,   220},  // royalblue
+  {106,  90, 205,   230},  // slateblue
+  {139,   0, 139,   240},  // darkmagenta
+  {148,   0, 211,   252},  // darkviolet
+  {138,  43, 226,   263},  // blueviolet
+  {153,  50, 204,   274},  // darkorchid
+  {112, 128, 144,   285},  // slategray
+  {147, 112, 219,   295},  // mediumpurple
+  {123, 104, 238,   308},  // mediumslateblue
+  {119, 136, 153,   324},  // lightslategray
+  { 34, 139,  34,   339},  // forestgreen
+  { 46, 139,  87,   351},  // seagreen
+  { 60, 179, 113,   360},  // mediumseagreen
+  {  0, 139, 139,   375},  // darkcyan
+  { 50, 205,  50,   384},  // limegreen
+  {  0, 255,   0,   394},  // lime
+  {  0, 255, 127,   399},  // springgreen
+  {  0, 250, 154,   411},  // mediumspringgreen
+  { 95, 158, 160,   429},  // cadetblue
+  {107, 142,  35,   439},  // olivedrab
+  {154, 205,  50,   449},  // yellowgreen
+  {143, 188, 143,   461},  // darkseagreen
+  {144, 238, 144,   474},  // lightgreen
+  {152, 251, 152,   485},  // palegreen
+  {124, 252,   0,   495},  // lawngreen
+  {127, 255,   0,   505},  // chartreuse
+  {173, 255,  47,   516},  // greenyellow
+  {169, 169, 169,   528},  // darkgray
+  { 32, 178, 170,   537},  // lightseagreen
+  {100, 149, 237,   551},  // cornflowerblue
+  { 30, 144, 255,   566},  // dodgerblue
+  {  0, 191, 255,   577},  // deepskyblue
+  {  0, 206, 209,   589},  // darkturquoise
+  { 72, 209, 204,   603},  // mediumturquoise
+  { 64, 224, 208,   619},  // turquoise
+  {  0, 255, 255,   629},  // aqua
+  {102, 205, 170,   634},  // mediumaquamarine
+  {176, 196, 222,   651},  // lightsteelblue
+  {135, 206, 235,   666},  // skyblue
+  {135, 206, 250,   674},  // lightskyblue
+  {173, 216, 230,   687},  // lightblue
+  {127, 255, 212,   697},  // aquamarine
+  {176, 224, 230,   708},  // powderblue
+  {175, 238, 238,   719},  // paleturquoise
+  {184, 134,  11,   733},  // darkgoldenrod
+  {210, 105,  30,   747},  // chocolate
+  {220,  20,  60,   757},  // crimson
+  {205,  92,  92,   765},  // indianred
+  {240, 128, 128,   775},  // lightcoral
+  {205, 133,  63,   786},  // peru
+  {218, 165,  32,   791},  // goldenrod
+  {189, 183, 107,   801},  // darkkhaki
+  {233, 150, 122,   811},  // darksalmon
+  {244, 164,  96,   822},  // sandybrown
+  {255,   0,   0,   833},  // red
+  {255,  69,   0,   837},  // orangered
+  {255,  99,  71,   847},  // tomato
+  {255, 127,  80,   854},  // coral
+  {250, 128, 114,   860},  // salmon
+  {255, 140,   0,   867},  // darkorange
+  {255, 165,   0,   878},  // orange
+  {255, 160, 122,   885},  // lightsalmon
+  {199,  21, 133,   897},  // mediumvioletred
+  {188, 143, 143,   913},  // rosybrown
+  {219, 112, 147,   923},  // palevioletred
+  {186,  85, 211,   937},  // mediumorchid
+  {218, 112, 214,   950},  // orchid
+  {210, 180, 140,   957},  // tan
+  {192, 192, 192,   961},  // silver
+  {211, 211, 211,   968},  // lightgray
+  {216, 191, 216,   978},  // thistle
+  {221, 160, 221,   986},  // plum
+  {255,  20, 147,   991},  // deeppink
+  {255, 105, 180,  1000},  // hotpink
+  {255,   0, 255,  1008},  // fuchsia
+  {238, 130, 238,  1016},  // violet
+  {222, 184, 135,  1023},  // burlywood
+  {255, 182, 193,  1033},  // lightpink
+  {255, 192, 203,  1043},  // pink
+  {255, 215,   0,  1048},  // gold
+  {238, 232, 170,  1053},  // palegoldenrod
+  {240, 230, 140,  1067},  // khaki
+  {245, 222, 179,  1073},  // wheat
+  {220, 220, 220,  1079},  // gainsboro
+  {250, 235, 215,  1089},  // antiquewhite
+  {255, 255,   0,  1102},  // yellow
+  {250, 250, 210,  1109},  // lightgoldenrodyellow
+  {245, 245, 220,  1130},  // beige
+  {255, 222, 173,  1136},  // navajowhite
+  {255, 228, 181,  1148},  // moccasin
+  {255, 218, 185,  1157},  // peachpuff
+  {255, 228, 196,  1167},  // bisque
+  {255, 235, 205,  1174},  // blanchedalmond
+  {255, 239, 213,  1189},  // papayawhip
+  {255, 250, 205,  1200},  // lemonchiffon
+  {255, 248, 220,  1213},  // cornsilk
+  {255, 255, 224,  1222},  // lightyellow
+  {255, 228, 225,  1234},  // mistyrose
+  {230, 230, 250,  1244},  // lavender
+  {245, 245, 245,  1253},  // whitesmoke
+  {240, 248, 255,  1264},  // aliceblue
+  {248, 248, 255,  1274},  // ghostwhite
+  {224, 255, 255,  1285},  // lightcyan
+  {240, 255, 240,  1295},  // honeydew
+  {245, 255, 250,  1304},  // mintcream
+  {240, 255, 255,  1314},  // azure
+  {250, 240, 230,  1320},  // linen
+  {253, 245, 230,  1326},  // oldlace
+  {255, 245, 238,  1334},  // seashell
+  {255, 240, 245,  1343},  // lavenderblush
+  {255, 250, 240,  1357},  // floralwhite
+  {255, 255, 240,  1369},  // ivory
+  {255, 250, 250,  1375},  // snow
+  {255, 255, 255,  1380},  // white
+};
+
+const Palette palette_css = {palette_css_entries, 139, palette_css_names};
+
+#endif
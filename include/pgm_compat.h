@@ -0,0 +1,20 @@
+#ifndef PGM_COMPAT_H
+#define PGM_COMPAT_H
+
+/*
+	PROGMEM access for code shared with the host build.
+	On the boards this is the Arduino one, on the PC flash is plain memory.
+*/
+
+#ifdef ARDUINO
+  #include <Arduino.h>
+#else
+  #include <stdint.h>
+  #define PROGMEM
+  #define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+  #define pgm_read_word(addr) (*(const uint16_t*)(addr))
+  #define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+  #define pgm_read_ptr(addr) (*(const void* const*)(addr))
+#endif
+
+#endif
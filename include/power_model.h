@@ -0,0 +1,41 @@
+#ifndef POWER_MODEL_H
+#define POWER_MODEL_H
+
+/*
+	Energy accounting per phase of the scan loop. Host-side model: the
+	bench adds the time spent in each phase, the firmware does not call
+	it. With the current drawn in each phase this gives the average
+	current, the duty cycle and the battery life. Plain arithmetic, no
+	timers here.
+*/
+
+#include <stdint.h>
+
+typedef enum {
+  POWER_ACTIVE,       // CPU running: reading, classifying, drawing
+  POWER_INTEGRATING,  // sensor integrating, CPU waiting for it
+  POWER_IDLE,         // between samples, nothing to do
+  POWER_PHASE_COUNT
+} PowerPhase;
+
+// Whole device current in each phase, in uA
+typedef struct {
+  uint32_t ua[POWER_PHASE_COUNT];
+} PowerProfile;
+
+typedef struct {
+  uint64_t us[POWER_PHASE_COUNT];
+} PowerModel;
+
+void powerModelReset(PowerModel* model);
+void powerModelAdd(PowerModel* model, PowerPhase phase, uint32_t us);
+
+uint64_t powerModelTotalUs(const PowerModel* model);
+// Average current over the accounted time, uA
+uint32_t powerModelAverageUa(const PowerModel* model, const PowerProfile* profile);
+// Share of the time spent in a phase, per mille
+uint16_t powerModelDutyPermille(const PowerModel* model, PowerPhase phase);
+// Hours of scanning on a battery of the given capacity
+uint32_t powerModelBatteryHours(const PowerModel* model, const PowerProfile* profile, uint32_t capacityMah);
+
+#endif
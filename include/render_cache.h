@@ -0,0 +1,52 @@
+#ifndef RENDER_CACHE_H
+#define RENDER_CACHE_H
+
+/*
+	Remembers what is on the display to avoid useless flushes over I2C.
+	Same bitmap and text: nothing to send. Same bitmap, new text: only the
+	pages (8 pixel rows) under the new text and the previous one are sent,
+	so the lines of a taller previous text are cleared too. Also counts the
+	framebuffer bytes actually sent and the ones saved.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Print the I2C byte counters with every redraw
+//#define RENDER_STATS
+
+typedef enum {
+  RENDER_SKIP,      // the display already shows this
+  RENDER_TEXT,      // only the text changed
+  RENDER_FULL       // new bitmap (or first frame)
+} RenderAction;
+
+typedef struct {
+  const unsigned char* bitmap;
+  uint32_t messageHash;
+  bool valid;
+  uint8_t textFirst;      // pages of the text on the display,
+  uint8_t textLast;       // textFirst > textLast when not known
+  uint32_t bytesSent;     // framebuffer bytes flushed
+  uint32_t bytesSaved;    // bytes a full flush every time would have added
+  uint16_t frames;        // draw requests
+  uint16_t skipped;       // draw requests with nothing to send
+} RenderCache;
+
+void renderCacheReset(RenderCache* cache);
+
+// What has to be sent for this frame; the cache then assumes it was drawn
+RenderAction renderCacheCheck(RenderCache* cache, const unsigned char* bitmap, const char* message);
+
+// Pages first..last under the text just laid out: widened to the pages
+// of the previous text, the ones a RENDER_TEXT frame has to send. The
+// cache then remembers first..last as the text on the display
+void renderCacheTextPages(RenderCache* cache, uint8_t* first, uint8_t* last);
+
+// Record a flush of sent bytes out of a full frame of fullBytes
+void renderCacheAccount(RenderCache* cache, uint16_t sent, uint16_t fullBytes);
+
+// Force the next frame to be sent in full (display cleared or reinitialized)
+void renderCacheInvalidate(RenderCache* cache);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef RENDER_MAILBOX_H
+#define RENDER_MAILBOX_H
+
+/*
+	Hand-off from the sensor side to the display side when they run in two
+	tasks (PIPELINED_TASKS on ESP32, threads on the host). It is a triple
+	buffer with one writer and one reader: the writer never waits, and the
+	reader always gets the latest result. Results posted while the reader
+	was busy drawing are overwritten and counted, never queued, so the
+	display does not fall behind the sensor. Lock-free with std::atomic,
+	so not built on AVR.
+*/
+
+#ifndef __AVR__
+
+#include <atomic>
+#include <stdint.h>
+
+#include "color_match.h"
+
+typedef struct {
+  uint32_t seq;           // numbered by the writer
+  RGBColor color;
+  ColorClass colorClass;
+  uint32_t distance;
+  uint32_t postedUs;      // writer clock when posted, for the latency
+} RenderJob;
+
+typedef struct {
+  RenderJob slots[3];
+  std::atomic<uint8_t> middle;  // slot between the two sides, RENDER_MAILBOX_FRESH when not taken yet
+  uint8_t back;                 // writer only: slot being filled
+  uint8_t front;                // reader only: slot being drawn
+  uint32_t posted;              // writer only
+  uint32_t coalesced;           // writer only: results replaced before the reader took them
+} RenderMailbox;
+
+#define RENDER_MAILBOX_FRESH 0x04
+
+void renderMailboxReset(RenderMailbox* mailbox);
+
+// Writer: publish a result, never blocks
+void renderMailboxPost(RenderMailbox* mailbox, const RenderJob* job);
+
+// Reader: the latest result if there is one it has not taken yet
+bool renderMailboxTake(RenderMailbox* mailbox, RenderJob* job);
+
+#endif
+
+#endif
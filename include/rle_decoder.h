@@ -0,0 +1,46 @@
+#ifndef RLE_DECODER_H
+#define RLE_DECODER_H
+
+/*
+	Decoder of the run-length compressed icons generated by
+	tools/gen_bitmaps.py (bitmap_rle.h, small_bitmap_rle.h).
+	The icon is read as spans of equal pixels, left to right and top to
+	bottom, that the display code draws as horizontal lines or ORs into
+	the page being composed; nothing is unpacked in RAM. The position is
+	kept in RleDecoder, so a page renderer continues where the previous
+	page stopped.
+*/
+
+#include <stdint.h>
+
+#include "pgm_compat.h"
+
+// Draw the compressed icons instead of bitmap.h / small_bitmap.h
+#define BITMAP_RLE
+
+typedef struct {
+  const unsigned char* data;  // PROGMEM asset
+  uint16_t nibble;            // next nibble of the run lengths
+  uint16_t run;               // pixels left in the current run
+  uint8_t value;              // pixel value of the current run
+  uint8_t width, height;
+  uint8_t x, y;               // next pixel
+} RleDecoder;
+
+static inline uint8_t rleAssetWidth(const unsigned char* asset) { return pgm_read_byte(asset); }
+static inline uint8_t rleAssetHeight(const unsigned char* asset) { return pgm_read_byte(asset + 1); }
+
+void rleBegin(RleDecoder* dec, const unsigned char* asset);
+
+// Length of the span starting at (dec->x, dec->y), cut at the end of the
+// row, and its pixel value in *value; 0 at the end of the icon.
+// The span is not consumed
+uint8_t rlePeek(RleDecoder* dec, uint8_t* value);
+
+// Move past length pixels of the span returned by rlePeek()
+void rleConsume(RleDecoder* dec, uint8_t length);
+
+// Skip to the start of row y (forward only)
+void rleSkipTo(RleDecoder* dec, uint8_t y);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef SAMPLE_PIPELINE_H
+#define SAMPLE_PIPELINE_H
+
+/*
+	What loop() does with one RGB reading before drawing: median filter,
+	classification and hysteresis (STABLE_DETECTION), a burst of readings
+	per answer (BURST_SAMPLING), or classification alone. Shared with the
+	host trace replay (bench_replay.cpp), so a recorded capture goes
+	through the same decisions as on the device.
+*/
+
+#include "color_burst.h"
+#include "color_filter.h"
+#include "color_match.h"
+
+typedef enum {
+  PIPELINE_SINGLE,      // every reading classified and drawn
+  PIPELINE_STABLE,      // median filter + hysteresis
+  PIPELINE_BURST        // robust mean of a burst, see color_burst.h
+} PipelineMode;
+
+typedef struct {
+  PipelineMode mode;
+  ColorFilter filter;
+  ClassHysteresis hysteresis;
+  ColorBurst burst;
+} SamplePipeline;
+
+typedef struct {
+  bool ready;                   // false while a burst is collecting: nothing below is set
+  RGBColor color;               // what the classifier saw (median or burst mean)
+  ColorClass colorClass;
+  uint32_t distance;            // from bestMatchRGB(), 0xFFFFFFFF when nothing matched
+  bool show;                    // draw colorClass now
+  ColorClass second;            // burst only: runner-up class (MatchScore)
+  uint8_t confidence;           // burst only: MatchScore.confidence
+  uint8_t readings;             // burst only: readings taken for this answer
+} PipelineResult;
+
+void samplePipelineReset(SamplePipeline* pipeline, PipelineMode mode);
+
+// One sensor reading through the pipeline
+void samplePipelineRun(SamplePipeline* pipeline, RGBColor sample, PipelineResult* result);
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef SPA_STRING_H
+#define SPA_STRING_H
+
+/*
+	Spanish language pack (-DLANGUAGE_ES), same names as ita_string.h.
+*/
+
+#define BROWN_STR       "MARRON"
+#define BLACK_STR       "NEGRO"
+#define WHITE_STR       "BLANCO"
+#define GREEN_STR       "VERDE"
+#define BLUE_STR        "AZUL"
+#define AZURE_STR       "CELESTE"
+#define RED_STR         "ROJO"
+#define PINK_STR        "ROSA"
+#define PURPLE_STR      "MORADO"
+#define ORANGESTR_STR   "NARANJA"
+#define GRAY_STR        "GRIS"
+#define YELLOW_STR      "AMARILLO"
+#define UNKNOWN_STR     "?????"
+
+#endif
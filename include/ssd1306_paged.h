@@ -0,0 +1,24 @@
+#ifndef SSD1306_PAGED_H
+#define SSD1306_PAGED_H
+
+/*
+	SSD1306 128x64 over I2C without a framebuffer: every page is composed
+	by page_renderer.h in a 128 byte buffer on the stack and sent right
+	away. Same init sequence and font as Adafruit_SSD1306/Adafruit GFX,
+	which would instead keep 1 KB of RAM allocated for the whole frame.
+*/
+
+#include <stdint.h>
+
+#include "page_renderer.h"
+
+// Classic 5x7 font of Adafruit GFX (glcdfont.c), for PageFrame.font
+extern const unsigned char* const ssd1306_paged_font;
+
+// Display init and clear, false if nothing answers at addr
+bool ssd1306PagedBegin(uint8_t addr);
+
+// Compose and send pages first..last of the frame
+void ssd1306PagedDraw(const PageFrame* frame, uint8_t first, uint8_t last);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef TCS3200_CAPTURE_H
+#define TCS3200_CAPTURE_H
+
+/*
+	Background TCS3200 reading with the Timer1 input capture of the
+	ATmega328 (sensor OUT on D8 = ICP1, S2/S3 on D6/D7).
+	The ISR measures the output period on every falling edge, averages it
+	over a gate time, then switches S2/S3 to the next filter by itself.
+	The main loop only collects the finished R/G/B triples.
+	Timer1 is taken by the driver (no analogWrite on D9/D10, no Servo).
+*/
+
+#include <stdint.h>
+
+typedef struct {
+  uint32_t ticks[3];    // sum of the measured periods, R, G, B (Timer1 ticks, 0.5 us)
+  uint16_t periods[3];  // number of periods in the sum, 0 = no edge (too dark / no sensor)
+} TCS3200Capture;
+
+// Start the measurements, gateMs is the time spent on each filter
+void tcs3200CaptureBegin(uint16_t gateMs);
+void tcs3200CaptureEnd();
+
+// Copy the last complete triple, true only once per new triple (never blocks)
+bool tcs3200CaptureRead(TCS3200Capture* capture);
+
+// Average LOW pulse width in microseconds, the unit pulseIn(OUT, LOW) gives,
+// so the redMin/redMax... calibration values keep working (50% duty cycle)
+static inline int tcs3200CapturePulseUs(const TCS3200Capture* capture, uint8_t channel)
+{
+  if (capture->periods[channel] == 0) {
+    return 0;
+  }
+  return (int)(capture->ticks[channel] / capture->periods[channel] / 4);
+}
+
+#endif
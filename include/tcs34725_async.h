@@ -0,0 +1,45 @@
+#ifndef TCS34725_ASYNC_H
+#define TCS34725_ASYNC_H
+
+/*
+	Non-blocking TCS34725 reading on top of Adafruit_TCS34725.
+	Every reading is one integration started by tcs34725AsyncStart(); the
+	poll function returns at once until it is over (integration time elapsed
+	and AVALID set, or INT pin low when TCS34725_INT_PIN is defined), then
+	reads RGBC and picks the integration time/gain of the next reading
+	(tcs34725_ranging.h).
+*/
+
+#include <Adafruit_TCS34725.h>
+
+#include "tcs34725_ranging.h"
+
+// Sensor INT output wired to this pin (open drain, active low), otherwise the STATUS register is polled
+//#define TCS34725_INT_PIN 2
+
+void tcs34725AsyncBegin(Adafruit_TCS34725& tcs);
+
+// Start the next integration, returns immediately
+void tcs34725AsyncStart(Adafruit_TCS34725& tcs);
+
+// True when a reading is ready and usable. A new integration is started
+// right away, with new settings if the ranging changed them.
+bool tcs34725AsyncPoll(Adafruit_TCS34725& tcs, TCS34725Raw* raw);
+
+// Current ranging step, 0 = 2.4 ms 1x
+uint8_t tcs34725AsyncStep();
+
+// Milliseconds until the running integration can be over, 0 if it may be already
+uint16_t tcs34725AsyncRemainingMs();
+
+// Time that passed without millis() counting it (AVR power-down,
+// lowPowerSleepMs()): the running integration is that much further on
+void tcs34725AsyncAddSleptMs(uint16_t ms);
+
+// Power the sensor down (PON and AEN cleared, about 2.5 uA), the running
+// integration is lost. Wake waits the 2.4 ms oscillator warm-up and starts
+// a new integration with the current step
+void tcs34725AsyncSleep(Adafruit_TCS34725& tcs);
+void tcs34725AsyncWake(Adafruit_TCS34725& tcs);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef TCS34725_RANGING_H
+#define TCS34725_RANGING_H
+
+/*
+	Automatic integration time / gain for the TCS34725.
+	The steps go from the fastest and least sensitive (2.4 ms, 1x) to the
+	slowest (154 ms, 60x); gain is raised before integration time so bright
+	surfaces are read with the shortest integration. After each reading the
+	next step is chosen from the clear channel.
+	Plain logic, no I2C here: the driver is tcs34725_async.h.
+*/
+
+#include <stdint.h>
+
+typedef struct {
+  uint16_t r, g, b, c;
+} TCS34725Raw;
+
+typedef struct {
+  uint8_t atime;      // ATIME register: 256 - number of 2.4 ms cycles
+  uint8_t gain;       // CONTROL register: 0 = 1x, 1 = 4x, 2 = 16x, 3 = 60x
+} TCS34725Step;
+
+#define TCS34725_RANGING_STEPS 9
+
+// Clear channel band the ranging aims for, in percent of the full scale
+#define TCS34725_RANGING_LOW_PCT 15
+#define TCS34725_RANGING_HIGH_PCT 85
+
+TCS34725Step tcs34725RangingStep(uint8_t step);
+
+// Integration time of a step in ms, rounded up
+uint16_t tcs34725RangingIntegrationMs(uint8_t step);
+
+// Full scale of the clear channel for a step
+uint16_t tcs34725RangingMaxCount(uint8_t step);
+
+// Step to use for the next reading. *usable tells if this reading can be
+// classified (clear channel not saturated and not lost in noise)
+uint8_t tcs34725RangingNext(uint8_t step, const TCS34725Raw* raw, bool* usable);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/*
+	Binary telemetry: one fixed size frame per sample instead of lines of
+	text on the serial port. tools/telemetry_decode.py turns the stream
+	into CSV.
+
+	Frame, multi-byte fields little endian:
+	  0     sync 0xA5
+	  1     sequence number (wraps, a gap means frames were dropped)
+	  2..9  raw red, green, blue, clear (uint16)
+	  10..12 RGBColor
+	  13    ColorClass (int8, -1 = undefined)
+	  14..15 best distance, saturated at 0xFFFF (also: no match)
+	  16..17 CRC-16/CCITT (poly 0x1021, init 0xFFFF) of bytes 1..15
+
+	Boot frame, sent once after the first result (boot_profile.h):
+	  0     sync 0x5A
+	  1..24 micros() at the end of each BootStage (uint32)
+	  25..26 CRC-16/CCITT of bytes 1..24
+
+	Memory frame, answer to the serial command 'M' (mem_stats.h):
+	  0     sync 0xC3
+	  1..16 free RAM, stack free, stack peak, heap break (uint32)
+	  17..18 CRC-16/CCITT of bytes 1..16
+*/
+
+#include <stdint.h>
+
+#include "boot_profile.h"
+#include "color_match.h"
+#include "mem_stats.h"
+
+#define TELEMETRY_SYNC 0xA5
+#define TELEMETRY_FRAME_SIZE 18
+#define TELEMETRY_BOOT_SYNC 0x5A
+#define TELEMETRY_BOOT_FRAME_SIZE (1 + 4 * BOOT_STAGE_COUNT + 2)
+#define TELEMETRY_MEM_SYNC 0xC3
+#define TELEMETRY_MEM_FRAME_SIZE (1 + 4 * 4 + 2)
+
+typedef struct {
+  uint8_t seq;
+  uint16_t raw[3];      // sensor counts (TCS34725) or pulse widths in us (TCS3200)
+  uint16_t clear;       // TCS34725 clear channel, 0 with the TCS3200
+  RGBColor color;       // what the classifier saw
+  ColorClass colorClass;
+  uint32_t distance;
+} TelemetrySample;
+
+uint16_t telemetryCrc16(const uint8_t* data, uint8_t length);
+
+// Frame of TELEMETRY_FRAME_SIZE bytes for the sample
+void telemetryEncode(const TelemetrySample* sample, uint8_t* frame);
+
+// Back from a frame, false on a bad sync byte or CRC. The distance comes
+// back saturated at 0xFFFF
+bool telemetryDecode(const uint8_t* frame, TelemetrySample* sample);
+
+// Boot frame of TELEMETRY_BOOT_FRAME_SIZE bytes, and back (false on a bad sync or CRC)
+void telemetryEncodeBoot(const BootProfile* profile, uint8_t* frame);
+bool telemetryDecodeBoot(const uint8_t* frame, BootProfile* profile);
+
+// Memory frame of TELEMETRY_MEM_FRAME_SIZE bytes, and back
+void telemetryEncodeMem(const MemStats* stats, uint8_t* frame);
+bool telemetryDecodeMem(const uint8_t* frame, MemStats* stats);
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "boot_profile.h"
+#include "pgm_compat.h"
+
+#define BOOT_ALL_MARKED ((uint8_t)((1u << BOOT_STAGE_COUNT) - 1))
+
+void bootProfileReset(BootProfile* profile)
+{
+  for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    profile->us[i] = 0;
+  }
+  profile->marked = 0;
+}
+
+bool bootProfileMark(BootProfile* profile, BootStage stage, uint32_t nowUs)
+{
+  uint8_t bit = (uint8_t)(1u << stage);
+  if (profile->marked & bit) {
+    return false;
+  }
+  profile->us[stage] = nowUs;
+  profile->marked |= bit;
+  return profile->marked == BOOT_ALL_MARKED;
+}
+
+bool bootProfileComplete(const BootProfile* profile)
+{
+  return profile->marked == BOOT_ALL_MARKED;
+}
+
+static const char boot_name_setup[] PROGMEM = "setup";
+static const char boot_name_config[] PROGMEM = "config";
+static const char boot_name_sensor[] PROGMEM = "sensor";
+static const char boot_name_display[] PROGMEM = "display";
+static const char boot_name_sample[] PROGMEM = "sample";
+static const char boot_name_result[] PROGMEM = "result";
+static const char boot_name_unknown[] PROGMEM = "?";
+
+static const char* const boot_stage_names[BOOT_STAGE_COUNT] PROGMEM = {
+  boot_name_setup, boot_name_config, boot_name_sensor,
+  boot_name_display, boot_name_sample, boot_name_result
+};
+
+const char* bootStageName(BootStage stage)
+{
+  if (stage >= BOOT_STAGE_COUNT) {
+    return boot_name_unknown;
+  }
+  return (const char*)pgm_read_ptr(&boot_stage_names[stage]);
+}
@@ -0,0 +1,38 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "class_descriptor.h"
+
+uint8_t classDescriptorIndex(ColorClass col)
+{
+  return col >= 0 && col < COLOR_CLASS_COUNT ? (uint8_t)col : COLOR_CLASS_COUNT;
+}
+
+void classDescriptorRead(const ClassDescriptor* table, ColorClass col, ClassDescriptor* out)
+{
+  const ClassDescriptor* entry = &table[classDescriptorIndex(col)];
+  out->bitmap = (const unsigned char*)pgm_read_ptr(&entry->bitmap);
+  out->name = (const char*)pgm_read_ptr(&entry->name);
+  out->textWidth = (int16_t)pgm_read_word(&entry->textWidth);
+}
+
+void classNameCopy(const ClassDescriptor* descriptor, char* buffer, size_t size)
+{
+  if (size == 0) {
+    return;
+  }
+  size_t i = 0;
+  for (; i + 1 < size; i++) {
+    char c = (char)pgm_read_byte(descriptor->name + i);
+    if (c == '\0') {
+      break;
+    }
+    buffer[i] = c;
+  }
+  buffer[i] = '\0';
+}
@@ -0,0 +1,101 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "color_burst.h"
+#include "color_filter.h"
+
+void colorBurstReset(ColorBurst* burst)
+{
+  burst->count = 0;
+  burst->kept = 0;
+  burst->used = 0;
+  burst->mean.r = burst->mean.g = burst->mean.b = 0;
+}
+
+static uint8_t channelOf(RGBColor color, uint8_t channel)
+{
+  return channel == 0 ? color.r : (channel == 1 ? color.g : color.b);
+}
+
+RGBColor colorBurstRobustMean(const ColorBurst* burst, uint8_t* kept)
+{
+  RGBColor result = {0, 0, 0};
+  uint8_t n = burst->count;
+  if (n == 0) {
+    if (kept) {
+      *kept = 0;
+    }
+    return result;
+  }
+  uint8_t center[3];
+  uint8_t limit[3];
+  uint8_t values[COLOR_BURST_MAX];
+  for (uint8_t c = 0; c < 3; c++) {
+    for (uint8_t i = 0; i < n; i++) {
+      values[i] = channelOf(burst->samples[i], c);
+    }
+    center[c] = colorFilterMedianOf(values, n);
+    for (uint8_t i = 0; i < n; i++) {
+      uint8_t v = channelOf(burst->samples[i], c);
+      values[i] = v > center[c] ? v - center[c] : center[c] - v;
+    }
+    // At least 1 count of MAD: identical readings must not reject the sensor's last bit of noise
+    uint8_t mad = colorFilterMedianOf(values, n);
+    uint16_t l = (uint16_t)COLOR_BURST_MAD_K * 3 * (mad ? mad : 1) / 2;
+    limit[c] = l > 255 ? 255 : (uint8_t)l;
+  }
+
+  uint16_t sum[3] = {0, 0, 0};
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    bool inside = true;
+    for (uint8_t c = 0; c < 3 && inside; c++) {
+      uint8_t v = channelOf(burst->samples[i], c);
+      inside = (v > center[c] ? v - center[c] : center[c] - v) <= limit[c];
+    }
+    if (inside) {
+      sum[0] += burst->samples[i].r;
+      sum[1] += burst->samples[i].g;
+      sum[2] += burst->samples[i].b;
+      count++;
+    }
+  }
+  if (count == 0) {
+    // Every reading is an outlier on some channel: the medians are all that is left
+    result.r = center[0];
+    result.g = center[1];
+    result.b = center[2];
+  } else {
+    result.r = (uint8_t)((sum[0] + count / 2) / count);
+    result.g = (uint8_t)((sum[1] + count / 2) / count);
+    result.b = (uint8_t)((sum[2] + count / 2) / count);
+  }
+  if (kept) {
+    *kept = count;
+  }
+  return result;
+}
+
+bool colorBurstAdd(ColorBurst* burst, RGBColor sample, MatchScore* score)
+{
+  burst->samples[burst->count++] = sample;
+  if (burst->count < COLOR_BURST_MIN) {
+    return false;
+  }
+  uint8_t kept;
+  RGBColor mean = colorBurstRobustMean(burst, &kept);
+  bestMatchRGBScore(mean, score);
+  if (score->confidence < COLOR_BURST_CONFIDENT && burst->count < COLOR_BURST_MAX) {
+    return false;
+  }
+  burst->mean = mean;
+  burst->kept = kept;
+  burst->used = burst->count;
+  burst->count = 0;
+  return true;
+}
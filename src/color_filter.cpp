@@ -0,0 +1,87 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "color_filter.h"
+
+void colorFilterReset(ColorFilter* filter)
+{
+  filter->head = 0;
+  filter->count = 0;
+}
+
+void colorFilterPush(ColorFilter* filter, RGBColor color)
+{
+  filter->samples[filter->head] = color;
+  filter->head = filter->head + 1 == COLOR_FILTER_SIZE ? 0 : filter->head + 1;
+  if (filter->count < COLOR_FILTER_SIZE) {
+    filter->count++;
+  }
+}
+
+uint8_t colorFilterMedianOf(uint8_t* values, uint8_t count)
+{
+  for (uint8_t i = 1; i < count; i++) {
+    uint8_t v = values[i];
+    uint8_t j = i;
+    while (j > 0 && values[j - 1] > v) {
+      values[j] = values[j - 1];
+      j--;
+    }
+    values[j] = v;
+  }
+  return values[count / 2];
+}
+
+RGBColor colorFilterMedian(const ColorFilter* filter)
+{
+  RGBColor result = {0, 0, 0};
+  if (filter->count == 0) {
+    return result;
+  }
+  uint8_t r[COLOR_FILTER_SIZE], g[COLOR_FILTER_SIZE], b[COLOR_FILTER_SIZE];
+  for (uint8_t i = 0; i < filter->count; i++) {
+    r[i] = filter->samples[i].r;
+    g[i] = filter->samples[i].g;
+    b[i] = filter->samples[i].b;
+  }
+  result.r = colorFilterMedianOf(r, filter->count);
+  result.g = colorFilterMedianOf(g, filter->count);
+  result.b = colorFilterMedianOf(b, filter->count);
+  return result;
+}
+
+void classHysteresisReset(ClassHysteresis* hysteresis)
+{
+  hysteresis->committed = COL_UNDEFINED;
+  hysteresis->candidate = COL_UNDEFINED;
+  hysteresis->streak = 0;
+  hysteresis->valid = false;
+}
+
+bool classHysteresisUpdate(ClassHysteresis* hysteresis, ColorClass observed)
+{
+  if (hysteresis->valid && observed == hysteresis->committed) {
+    hysteresis->streak = 0;
+    return false;
+  }
+  if (observed == hysteresis->candidate) {
+    if (hysteresis->streak < CLASS_HYSTERESIS_SAMPLES) {
+      hysteresis->streak++;
+    }
+  } else {
+    hysteresis->candidate = observed;
+    hysteresis->streak = 1;
+  }
+  if (hysteresis->streak >= CLASS_HYSTERESIS_SAMPLES) {
+    hysteresis->committed = observed;
+    hysteresis->valid = true;
+    hysteresis->streak = 0;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,67 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "color_lab.h"
+#include "color_lab_tables.h"
+
+// f(t) of the CIELAB definition, t and result in Q16 (1.0 = 65535).
+// Dark values use the finer table, the cube root is steep near zero
+static uint16_t labF(uint16_t t)
+{
+  const uint16_t* table = lab_f_q16;
+  if (t < 4096) {
+    table = lab_f_low_q16;
+    t <<= 4;
+  }
+  uint8_t index = t >> 8;
+  uint8_t frac = t & 0xFF;
+  uint16_t f0 = pgm_read_word(&table[index]);
+  uint16_t f1 = pgm_read_word(&table[index + 1]);
+  return f0 + (uint16_t)(((uint32_t)(f1 - f0) * frac + 128) >> 8);
+}
+
+LabColor rgbToLab(RGBColor color)
+{
+  uint32_t r = pgm_read_word(&srgb_to_linear_q16[color.r]);
+  uint32_t g = pgm_read_word(&srgb_to_linear_q16[color.g]);
+  uint32_t b = pgm_read_word(&srgb_to_linear_q16[color.b]);
+
+  // XYZ relative to the white point, Q14 matrix so the result is Q16 again
+  uint16_t x = (uint16_t)((r * LAB_M_XR + g * LAB_M_XG + b * LAB_M_XB + 8192) >> 14);
+  uint16_t y = (uint16_t)((r * LAB_M_YR + g * LAB_M_YG + b * LAB_M_YB + 8192) >> 14);
+  uint16_t z = (uint16_t)((r * LAB_M_ZR + g * LAB_M_ZG + b * LAB_M_ZB + 8192) >> 14);
+
+  int32_t fx = labF(x);
+  int32_t fy = labF(y);
+  int32_t fz = labF(z);
+
+  LabColor lab;
+  lab.l = (int16_t)(((116L * LAB_SCALE * fy + 32768) >> 16) - 16 * LAB_SCALE);
+  lab.a = (int16_t)((500L * LAB_SCALE * (fx - fy) + 32768) >> 16);
+  lab.b = (int16_t)((200L * LAB_SCALE * (fy - fz) + 32768) >> 16);
+  return lab;
+}
+
+ColorClass bestMatchLabTable(const ColoReference* table, const LabColor* labTable, size_t count,
+                             RGBColor currentColor, uint32_t* minDist)
+{
+  LabColor lab = rgbToLab(currentColor);
+  uint32_t bestDist = 0xFFFFFFFF;
+  ColorClass best = COL_UNDEFINED;
+  for (size_t i = 0; i < count; i++) {
+    uint32_t dist = labDistance(lab, labTable[i]);
+    if (dist < bestDist && dist <= LAB_THRESHOLD) {
+      bestDist = dist;
+      best = table[i].color_class;
+    }
+  }
+  if (minDist) {
+    *minDist = bestDist;
+  }
+  return best;
+}
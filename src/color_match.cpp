@@ -0,0 +1,423 @@
+/*
+
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "color_match.h"
+#ifdef COLOR_MATCH_LUT
+  #include "color_lut.h"
+#endif
+#ifdef COLOR_MATCH_LAB
+  #include "color_lab.h"
+  #ifdef COLOR_MATCH_LUT
+    #error COLOR_MATCH_LAB and COLOR_MATCH_LUT are exclusive: the RGB cube is built with the RGB distance.
+  #endif
+#endif
+#ifdef COLOR_MATCH_CALIBRATED
+  #include "color_calibration.h"
+  #ifdef COLOR_MATCH_LUT
+    #error The RGB cube is built from the tables below, use COLOR_MATCH_CALIBRATED without COLOR_MATCH_LUT.
+  #endif
+#endif
+
+//Calibrate this value with your specific sensor
+const ColoReference color_reference_esp32c3[] = {
+  {{50,   50,   50},  COL_GRAY},    // GRAY
+  {{155,  53,   41},  COL_RED},     // RED
+  {{147,  44,   44},  COL_RED},     // RED Dark
+  {{151,  53,   39},  COL_RED},     // RED Light
+  {{125,   80,  30},  COL_YELLOW},  // YELLOW
+  {{130,  76,  32},  COL_YELLOW},  // YELLOW Dark
+  {{118,  87,  30},  COL_YELLOW},  // YELLOW Light
+  {{72,   107,  55},  COL_GREEN},   // GREEN 
+  {{71,   97,  68},  COL_GREEN},   // GREEN Dark
+  {{72,   112,  47},  COL_GREEN},   // GREEN Light
+  {{61,   81,   93}, COL_BLUE},    // BLU dark
+  {{57,   82,   96}, COL_BLUE},    // BLU light
+  {{125,   73,   41},  COL_BROWN},   // BROWN
+  {{124,   70,   44},  COL_BROWN},   // BROWN dark
+  {{119,   79,   43},  COL_BROWN},   // BROWN light
+  {{144,  64,   34},  COL_ORANGE},  // ORANGE 
+  {{148,  59,   35},  COL_ORANGE},  // ORANGE dark
+  {{138,  70,   33},  COL_ORANGE},  // ORANGE light
+  {{74,   69,   94}, COL_PURPLE},  // PURPLE 
+  {{128,   54,   62}, COL_PURPLE},  // PURPLE light
+  {{118,   66,   56},  COL_PINK},    // PINK
+  {{114,   85,   59},  COL_PINK},    // PINK light
+  {{60,   88,   93}, COL_AZURE},    // AZURE 
+  {{52,   91,  97}, COL_AZURE}    // AZURE scuro
+};
+const size_t color_reference_esp32c3_count = sizeof(color_reference_esp32c3)/sizeof(color_reference_esp32c3[0]);
+
+const ColoReference color_reference_nano[] = {
+  {{50,   50,   50},  COL_GRAY},    // GRAY
+  {{112,  79,   71},  COL_RED},     // RED
+  {{108,  78,   73},  COL_RED},     // RED Dark
+  {{120,  76,   66},  COL_RED},     // RED Light
+  {{92,   106,  50},  COL_YELLOW},  // YELLOW
+  {{104,  100,  51},  COL_YELLOW},  // YELLOW Dark
+  {{57,   115,  85},  COL_GREEN},   // GREEN 
+  {{53,   109,  95},  COL_GREEN},   // GREEN Dark
+  {{77,   117,  71},  COL_GREEN},   // GREEN Light
+  {{51,   96,   107}, COL_BLUE},    // BLU dark
+  {{43,   95,   119}, COL_BLUE},    // BLU light
+  {{95,   92,   70},  COL_BROWN},   // BROWN
+  {{91,   93,   70},  COL_BROWN},   // BROWN dark
+  {{95,   92,   66},  COL_BROWN},   // BROWN light
+  {{113,  87,   60},  COL_ORANGE},  // ORANGE 
+  {{117,  82,   62},  COL_ORANGE},  // ORANGE dark
+  {{111,  90,   56},  COL_ORANGE},  // ORANGE light
+  {{53,   85,   117}, COL_PURPLE},  // PURPLE 
+  {{95,   76,   90}, COL_PURPLE},  // PURPLE light
+  {{85,   93,   80},  COL_PINK},    // PINK
+  {{90,   84,   85},  COL_PINK},    // PINK dark
+  {{76,   95,   86},  COL_PINK},    // PINK light
+  {{41,   98,   117}, COL_AZURE},    // AZURE 
+  {{38,   100,  119}, COL_AZURE}    // AZURE scuro
+};
+const size_t color_reference_nano_count = sizeof(color_reference_nano)/sizeof(color_reference_nano[0]);
+
+#if defined(COLOR_MATCH_CALIBRATED)
+  // Learned on this sensor unit, whatever the board
+  #define COLOR_REFERENCE_TABLE color_reference_calibrated
+#elif defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
+  #define COLOR_REFERENCE_TABLE color_reference_esp32c3
+  #if COLOR_LUT_BITS == 4
+    #define COLOR_REFERENCE_LUT color_reference_esp32c3_lut4
+  #else
+    #define COLOR_REFERENCE_LUT color_reference_esp32c3_lut5
+  #endif
+#else
+  #define COLOR_REFERENCE_TABLE color_reference_nano
+  #if COLOR_LUT_BITS == 4
+    #define COLOR_REFERENCE_LUT color_reference_nano_lut4
+  #else
+    #define COLOR_REFERENCE_LUT color_reference_nano_lut5
+  #endif
+#endif
+#define COLOR_REFERENCE_COUNT (sizeof(COLOR_REFERENCE_TABLE)/sizeof(COLOR_REFERENCE_TABLE[0]))
+
+const ColoReference* const color_reference = COLOR_REFERENCE_TABLE;
+const size_t color_reference_count = COLOR_REFERENCE_COUNT;
+
+#ifndef COLOR_MATCH_LUT
+// Table bestMatchRGB() scans: the built-in one until colorMatchSetTable()
+static const ColoReference* match_table = COLOR_REFERENCE_TABLE;
+static size_t match_count = COLOR_REFERENCE_COUNT;
+  #ifdef COLOR_MATCH_CALIBRATED
+static const uint16_t* match_thresholds = color_threshold_calibrated;
+  #else
+static const uint16_t* match_thresholds = nullptr;  // THRESHOLD for every class
+  #endif
+#endif
+
+#ifdef COLOR_MATCH_LAB
+// References converted once, on the first match
+static LabColor color_reference_lab[COLOR_REFERENCE_COUNT];
+static bool color_reference_lab_ready = false;
+
+static const LabColor* labReferences()
+{
+  if (!color_reference_lab_ready) {
+    for (size_t i = 0; i < match_count; i++) {
+      color_reference_lab[i] = rgbToLab(match_table[i].reference_color);
+    }
+    color_reference_lab_ready = true;
+  }
+  return color_reference_lab;
+}
+#endif
+
+bool colorMatchSetTable(const ColoReference* table, size_t count, const uint16_t* thresholds)
+{
+#if defined(COLOR_MATCH_LUT)
+  (void)table;
+  (void)count;
+  (void)thresholds;
+  return false;
+#else
+  #ifdef COLOR_MATCH_LAB
+  if (count > COLOR_REFERENCE_COUNT) {
+    return false;
+  }
+  color_reference_lab_ready = false;
+  #endif
+  if (!table) {
+    match_table = COLOR_REFERENCE_TABLE;
+    match_count = COLOR_REFERENCE_COUNT;
+  #ifdef COLOR_MATCH_CALIBRATED
+    match_thresholds = color_threshold_calibrated;
+  #else
+    match_thresholds = nullptr;
+  #endif
+    return true;
+  }
+  match_table = table;
+  match_count = count;
+  match_thresholds = thresholds;
+  return true;
+#endif
+}
+
+// We calculate color as the minimum distance in 3 dimensions
+// (ignoring the square root which does not change for the purposes of finding the closest)
+ColorClass bestMatchRGBTable(const ColoReference* table, size_t count, RGBColor currentColor, uint32_t* minDist)
+{
+  uint32_t bestDist = 0xFFFFFFFF;
+  ColorClass best = COL_UNDEFINED;
+  for (size_t i = 0; i < count; i++) {
+    int16_t dr = (int16_t)currentColor.r - table[i].reference_color.r;
+    int16_t dg = (int16_t)currentColor.g - table[i].reference_color.g;
+    int16_t db = (int16_t)currentColor.b - table[i].reference_color.b;
+    // 32 bit products: on AVR int is 16 bit and 255*255 would overflow
+    uint32_t dist = (uint32_t)((int32_t)dr*dr) + (uint32_t)((int32_t)dg*dg) + (uint32_t)((int32_t)db*db);
+    if (dist < bestDist && dist <= THRESHOLD) {
+      bestDist = dist;
+      best = table[i].color_class;
+    }
+  }
+  if (minDist) {
+    *minDist = bestDist;
+  }
+  return best;
+}
+
+// A separate loop so that the plain THRESHOLD scan keeps its constant compare
+ColorClass bestMatchRGBTableThresholds(const ColoReference* table, size_t count, const uint16_t* thresholds,
+                                       RGBColor currentColor, uint32_t* minDist)
+{
+  uint32_t bestDist = 0xFFFFFFFF;
+  ColorClass best = COL_UNDEFINED;
+  for (size_t i = 0; i < count; i++) {
+    int16_t dr = (int16_t)currentColor.r - table[i].reference_color.r;
+    int16_t dg = (int16_t)currentColor.g - table[i].reference_color.g;
+    int16_t db = (int16_t)currentColor.b - table[i].reference_color.b;
+    uint32_t dist = (uint32_t)((int32_t)dr*dr) + (uint32_t)((int32_t)dg*dg) + (uint32_t)((int32_t)db*db);
+    if (dist < bestDist && dist <= thresholds[table[i].color_class]) {
+      bestDist = dist;
+      best = table[i].color_class;
+    }
+  }
+  if (minDist) {
+    *minDist = bestDist;
+  }
+  return best;
+}
+
+ColorClass bestMatchRGBLut(const ColorLut* lut, const ColoReference* table, RGBColor currentColor, uint32_t* minDist)
+{
+  uint8_t cell = colorLutCell(lut, currentColor);
+  if (cell < COLOR_LUT_LISTS) {
+    if (minDist) {
+      *minDist = cell == 0 ? 0xFFFFFFFF : 0;
+    }
+    return (ColorClass)((int8_t)cell - 1);
+  }
+  // The same compare as bestMatchRGBTable(), on the references of the list
+  uint8_t list = cell - COLOR_LUT_LISTS;
+  uint16_t end = pgm_read_word(lut->starts + list + 1);
+  uint32_t bestDist = 0xFFFFFFFF;
+  ColorClass best = COL_UNDEFINED;
+  for (uint16_t k = pgm_read_word(lut->starts + list); k < end; k++) {
+    const ColoReference* ref = &table[pgm_read_byte(lut->lists + k)];
+    int16_t dr = (int16_t)currentColor.r - ref->reference_color.r;
+    int16_t dg = (int16_t)currentColor.g - ref->reference_color.g;
+    int16_t db = (int16_t)currentColor.b - ref->reference_color.b;
+    uint32_t dist = (uint32_t)((int32_t)dr*dr) + (uint32_t)((int32_t)dg*dg) + (uint32_t)((int32_t)db*db);
+    if (dist < bestDist && dist <= THRESHOLD) {
+      bestDist = dist;
+      best = ref->color_class;
+    }
+  }
+  if (minDist) {
+    *minDist = bestDist;
+  }
+  return best;
+}
+
+ColorClass bestMatchRGB(RGBColor currentColor, uint32_t* minDist)
+{
+#ifdef COLOR_MATCH_LUT
+  return bestMatchRGBLut(&COLOR_REFERENCE_LUT, COLOR_REFERENCE_TABLE, currentColor, minDist);
+#elif defined(COLOR_MATCH_LAB)
+  return bestMatchLabTable(match_table, labReferences(), match_count, currentColor, minDist);
+#else
+  if (match_thresholds) {
+    return bestMatchRGBTableThresholds(match_table, match_count, match_thresholds, currentColor, minDist);
+  }
+  return bestMatchRGBTable(match_table, match_count, currentColor, minDist);
+#endif
+}
+
+// 255 * (far - near) / far in 32 bits: both scaled down until the product fits
+static uint8_t scoreMargin(uint32_t nearDist, uint32_t farDist)
+{
+  if (farDist == 0 || nearDist >= farDist) {
+    return 0;
+  }
+  while (farDist > 0x00FFFFFF) {
+    farDist >>= 1;
+    nearDist >>= 1;
+  }
+  return (uint8_t)((farDist - nearDist) * 255 / farDist);
+}
+
+// Largest distance accepted for a class, as in the scans above
+static uint32_t scoreLimit(const uint16_t* thresholds, uint8_t cls)
+{
+#ifdef COLOR_MATCH_LAB
+  (void)thresholds;
+  (void)cls;
+  return LAB_THRESHOLD;   // bestMatchLabTable() has no per-class thresholds
+#else
+  return thresholds ? thresholds[cls] : THRESHOLD;
+#endif
+}
+
+// One scan keeping the nearest reference of every class, then the same
+// choice as bestMatchRGB(): the nearest one within the limit of its class
+void bestMatchRGBScore(RGBColor currentColor, MatchScore* score)
+{
+#ifdef COLOR_MATCH_LUT
+  // The cube is built from the built-in table, scanning it gives the same class
+  const ColoReference* table = COLOR_REFERENCE_TABLE;
+  size_t count = COLOR_REFERENCE_COUNT;
+  const uint16_t* thresholds = nullptr;
+#else
+  const ColoReference* table = match_table;
+  size_t count = match_count;
+  const uint16_t* thresholds = match_thresholds;
+#endif
+#ifdef COLOR_MATCH_LAB
+  const LabColor* labTable = labReferences();
+  LabColor lab = rgbToLab(currentColor);
+#endif
+  uint32_t classDist[COLOR_CLASS_COUNT];
+  uint16_t classFirst[COLOR_CLASS_COUNT];   // table order breaks ties, as in the scan
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    classDist[c] = 0xFFFFFFFF;
+    classFirst[c] = 0xFFFF;
+  }
+  for (size_t i = 0; i < count; i++) {
+#ifdef COLOR_MATCH_LAB
+    uint32_t dist = labDistance(lab, labTable[i]);
+#else
+    int16_t dr = (int16_t)currentColor.r - table[i].reference_color.r;
+    int16_t dg = (int16_t)currentColor.g - table[i].reference_color.g;
+    int16_t db = (int16_t)currentColor.b - table[i].reference_color.b;
+    uint32_t dist = (uint32_t)((int32_t)dr*dr) + (uint32_t)((int32_t)dg*dg) + (uint32_t)((int32_t)db*db);
+#endif
+    uint8_t cls = (uint8_t)table[i].color_class;
+    if (dist < classDist[cls]) {
+      classDist[cls] = dist;
+      classFirst[cls] = (uint16_t)i;
+    }
+  }
+
+  // best: nearest class within its limit, nearest: nearest class at all
+  int8_t best = -1;
+  int8_t nearest = -1;
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    if (classFirst[c] == 0xFFFF) {
+      continue;
+    }
+    if (nearest < 0 || classDist[c] < classDist[nearest]
+        || (classDist[c] == classDist[nearest] && classFirst[c] < classFirst[nearest])) {
+      nearest = c;
+    }
+    if (classDist[c] <= scoreLimit(thresholds, c) && (best < 0 || classDist[c] < classDist[best]
+        || (classDist[c] == classDist[best] && classFirst[c] < classFirst[best]))) {
+      best = c;
+    }
+  }
+  // Runner-up: the nearest other class, even beyond its limit
+  int8_t shown = best >= 0 ? best : nearest;
+  int8_t second = -1;
+  for (uint8_t c = 0; c < COLOR_CLASS_COUNT; c++) {
+    if (c != shown && classFirst[c] != 0xFFFF && (second < 0 || classDist[c] < classDist[second])) {
+      second = c;
+    }
+  }
+
+  score->best = (ColorClass)best;
+  score->bestDist = best >= 0 ? classDist[best] : 0xFFFFFFFF;
+  if (best >= 0) {
+    score->second = (ColorClass)second;
+    score->secondDist = second >= 0 ? classDist[second] : 0xFFFFFFFF;
+    // Close to another class or close to the edge of its own: both are a coin toss
+    uint8_t toSecond = second >= 0 ? scoreMargin(classDist[best], classDist[second]) : 255;
+    uint8_t toLimit = scoreMargin(classDist[best], scoreLimit(thresholds, best));
+    score->confidence = toSecond < toLimit ? toSecond : toLimit;
+  } else if (nearest >= 0) {
+    // Nothing matched: how far the nearest class is beyond its limit
+    score->second = (ColorClass)nearest;
+    score->secondDist = classDist[nearest];
+    score->confidence = scoreMargin(scoreLimit(thresholds, nearest), classDist[nearest]);
+  } else {
+    score->second = COL_UNDEFINED;
+    score->secondDist = 0xFFFFFFFF;
+    score->confidence = 255;
+  }
+}
+
+// Converting from raw to 0-255 scale (mapping the range between your minimums and maximums).
+// Same integer math as Arduino map(); an empty range gives -1 like map() does on AVR
+uint8_t tcs3200RawToChannel(int raw, int rawMin, int rawMax)
+{
+  long value;
+  if (rawMax == rawMin) {
+    value = -1;
+  } else {
+    value = ((long)raw - rawMin) * (0 - 255) / ((long)rawMax - rawMin) + 255;
+  }
+  // Limit values between 0 and 255
+  if (value < 0) {
+    return 0;
+  }
+  if (value > 255) {
+    return 255;
+  }
+  return (uint8_t)value;
+}
+
+// Channels normalized on the clear one with one 32 bit division for the three of
+// them: recip = 255/c in Q16, then a multiply and a shift per channel.
+// Same values as Adafruit_TCS34725::getRGB() truncated to uint8_t, within +-1,
+// without soft-float; channels above the clear one saturate at 255
+RGBColor tcs34725RawToRGB(uint16_t r, uint16_t g, uint16_t b, uint16_t c)
+{
+  RGBColor color;
+  // Avoid divide by zero errors, if clear = 0 return black
+  if (c == 0) {
+    color.r = color.g = color.b = 0;
+    return color;
+  }
+  uint32_t recip = (255UL << 16) / c;
+  color.r = r >= c ? 255 : (uint8_t)(((uint32_t)r * recip) >> 16);
+  color.g = g >= c ? 255 : (uint8_t)(((uint32_t)g * recip) >> 16);
+  color.b = b >= c ? 255 : (uint8_t)(((uint32_t)b * recip) >> 16);
+  return color;
+}
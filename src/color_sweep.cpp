@@ -0,0 +1,111 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "color_sweep.h"
+
+static uint16_t addMs(uint16_t a, uint16_t b)
+{
+  uint32_t sum = (uint32_t)a + b;
+  return sum > 0xFFFF ? 0xFFFF : (uint16_t)sum;
+}
+
+void colorSweepReset(ColorSweep* sweep)
+{
+  sweep->count = 0;
+  sweep->truncated = false;
+  sweep->candidate = COL_UNDEFINED;
+  sweep->streak = 0;
+  sweep->candidateMs = 0;
+  sweep->undefinedMs = 0;
+}
+
+bool colorSweepAdd(ColorSweep* sweep, ColorClass observed, uint16_t elapsedMs)
+{
+  sweep->undefinedMs = observed == COL_UNDEFINED ? addMs(sweep->undefinedMs, elapsedMs) : 0;
+  if (sweep->count == 0 && observed == COL_UNDEFINED) {
+    sweep->streak = 0;          // not started: nothing under the sensor yet
+    return false;
+  }
+  SweepSegment* current = sweep->count ? &sweep->segments[sweep->count - 1] : nullptr;
+  if (current && observed == current->colorClass) {
+    // A run too short to count belongs to the segment around it
+    current->ms = addMs(current->ms, addMs(sweep->candidateMs, elapsedMs));
+    sweep->streak = 0;
+    sweep->candidateMs = 0;
+    return false;
+  }
+  if (sweep->streak && observed == sweep->candidate) {
+    sweep->streak++;
+    sweep->candidateMs = addMs(sweep->candidateMs, elapsedMs);
+  } else {
+    if (current) {
+      current->ms = addMs(current->ms, sweep->candidateMs);
+    }
+    sweep->candidate = observed;
+    sweep->streak = 1;
+    sweep->candidateMs = elapsedMs;
+  }
+  if (sweep->streak < SWEEP_DEBOUNCE_SAMPLES) {
+    return false;
+  }
+  sweep->streak = 0;
+  if (sweep->count == SWEEP_MAX_SEGMENTS) {
+    sweep->truncated = true;
+    sweep->candidateMs = 0;
+    return false;
+  }
+  SweepSegment* next = &sweep->segments[sweep->count++];
+  next->colorClass = (int8_t)sweep->candidate;
+  next->ms = sweep->candidateMs;
+  sweep->candidateMs = 0;
+  return true;
+}
+
+bool colorSweepEnded(const ColorSweep* sweep, uint16_t idleMs)
+{
+  return sweep->count > 0 && sweep->undefinedMs >= idleMs;
+}
+
+uint8_t colorSweepFormat(const ColorSweep* sweep, const ClassDescriptor* table, char* out, uint8_t size)
+{
+  uint8_t length = 0;
+  bool cut = sweep->truncated;
+  out[0] = '\0';
+  for (uint8_t i = 0; i < sweep->count; i++) {
+    ColorClass col = (ColorClass)sweep->segments[i].colorClass;
+    if (col == COL_UNDEFINED) {
+      continue;
+    }
+    ClassDescriptor descriptor;
+    classDescriptorRead(table, col, &descriptor);
+    char name[CLASS_NAME_SIZE];
+    classNameCopy(&descriptor, name, sizeof(name));
+    uint8_t nameLength = 0;
+    while (name[nameLength]) {
+      nameLength++;
+    }
+    // Separator, name, and room left for ".." and the terminator
+    uint8_t needed = (length ? 1 : 0) + nameLength;
+    if (length + needed + 3 > size) {
+      cut = true;
+      break;
+    }
+    if (length) {
+      out[length++] = SWEEP_SEPARATOR;
+    }
+    for (uint8_t k = 0; k < nameLength; k++) {
+      out[length++] = name[k];
+    }
+  }
+  if (cut && length + 3 <= size) {
+    out[length++] = '.';
+    out[length++] = '.';
+  }
+  out[length] = '\0';
+  return length;
+}
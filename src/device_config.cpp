@@ -0,0 +1,218 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "device_config.h"
+#include "tcs34725_ranging.h"
+#include "telemetry.h"
+
+#if defined(__AVR__)
+  #include <avr/eeprom.h>
+  #define DEVICE_CONFIG_EEPROM_ADDR 0
+#elif defined(ESP32)
+  #include <Preferences.h>
+#elif !defined(ARDUINO)
+  #include <stdio.h>
+#endif
+
+#define RECORD_REFERENCES 16
+#define RECORD_THRESHOLDS (RECORD_REFERENCES + 4 * DEVICE_CONFIG_MAX_REFERENCES)
+#define RECORD_CRC (DEVICE_CONFIG_RECORD_SIZE - 2)
+
+static void putU16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t getU16(const uint8_t* p)
+{
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+void deviceConfigDefaults(DeviceConfig* config)
+{
+  for (uint8_t i = 0; i < 3; i++) {
+    config->tcs3200Min[i] = 0;
+    config->tcs3200Max[i] = 0;
+  }
+  config->tcs34725Gain = DEVICE_CONFIG_DEFAULT_GAIN;
+  config->referenceCount = 0;
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT; i++) {
+    config->thresholds[i] = THRESHOLD;
+  }
+}
+
+void deviceConfigEncode(const DeviceConfig* config, uint8_t* record)
+{
+  record[0] = DEVICE_CONFIG_MAGIC;
+  record[1] = DEVICE_CONFIG_VERSION;
+  for (uint8_t i = 0; i < 3; i++) {
+    putU16(record + 2 + 2 * i, (uint16_t)config->tcs3200Min[i]);
+    putU16(record + 8 + 2 * i, (uint16_t)config->tcs3200Max[i]);
+  }
+  record[14] = config->tcs34725Gain;
+  record[15] = config->referenceCount;
+  for (uint8_t i = 0; i < DEVICE_CONFIG_MAX_REFERENCES; i++) {
+    uint8_t* p = record + RECORD_REFERENCES + 4 * i;
+    if (i < config->referenceCount) {
+      p[0] = config->references[i].reference_color.r;
+      p[1] = config->references[i].reference_color.g;
+      p[2] = config->references[i].reference_color.b;
+      p[3] = (uint8_t)(int8_t)config->references[i].color_class;
+    } else {
+      p[0] = p[1] = p[2] = 0;
+      p[3] = (uint8_t)(int8_t)COL_UNDEFINED;
+    }
+  }
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT; i++) {
+    putU16(record + RECORD_THRESHOLDS + 2 * i, config->thresholds[i]);
+  }
+  putU16(record + RECORD_CRC, telemetryCrc16(record, RECORD_CRC));
+}
+
+bool deviceConfigDecode(const uint8_t* record, DeviceConfig* config)
+{
+  if (record[0] != DEVICE_CONFIG_MAGIC || record[1] != DEVICE_CONFIG_VERSION
+      || getU16(record + RECORD_CRC) != telemetryCrc16(record, RECORD_CRC)
+      || record[14] > 3 || record[15] > DEVICE_CONFIG_MAX_REFERENCES) {
+    return false;
+  }
+  for (uint8_t i = 0; i < record[15]; i++) {
+    int8_t cls = (int8_t)record[RECORD_REFERENCES + 4 * i + 3];
+    if (cls < 0 || cls >= COLOR_CLASS_COUNT) {
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < 3; i++) {
+    config->tcs3200Min[i] = (int16_t)getU16(record + 2 + 2 * i);
+    config->tcs3200Max[i] = (int16_t)getU16(record + 8 + 2 * i);
+  }
+  config->tcs34725Gain = record[14];
+  config->referenceCount = record[15];
+  for (uint8_t i = 0; i < config->referenceCount; i++) {
+    const uint8_t* p = record + RECORD_REFERENCES + 4 * i;
+    config->references[i].reference_color.r = p[0];
+    config->references[i].reference_color.g = p[1];
+    config->references[i].reference_color.b = p[2];
+    config->references[i].color_class = (ColorClass)(int8_t)p[3];
+  }
+  for (uint8_t i = 0; i < COLOR_CLASS_COUNT; i++) {
+    config->thresholds[i] = getU16(record + RECORD_THRESHOLDS + 2 * i);
+  }
+  return true;
+}
+
+uint8_t deviceConfigPickGain(const uint16_t clearAtGain[4], uint16_t fullScale)
+{
+  uint32_t high = (uint32_t)fullScale * TCS34725_RANGING_HIGH_PCT / 100;
+  for (uint8_t gain = 3; gain > 0; gain--) {
+    if (clearAtGain[gain] < high) {
+      return gain;
+    }
+  }
+  return 0;
+}
+
+#if defined(__AVR__)
+
+static bool storageRead(uint8_t* record)
+{
+  eeprom_read_block(record, (const void*)DEVICE_CONFIG_EEPROM_ADDR, DEVICE_CONFIG_RECORD_SIZE);
+  return true;
+}
+
+static bool storageWrite(const uint8_t* record)
+{
+  // update: only the bytes that changed are written, EEPROM cells wear out
+  eeprom_update_block(record, (void*)DEVICE_CONFIG_EEPROM_ADDR, DEVICE_CONFIG_RECORD_SIZE);
+  return true;
+}
+
+#elif defined(ESP32)
+
+static bool storageRead(uint8_t* record)
+{
+  Preferences prefs;
+  if (!prefs.begin("cbh", true)) {
+    return false;
+  }
+  size_t length = prefs.getBytes("config", record, DEVICE_CONFIG_RECORD_SIZE);
+  prefs.end();
+  return length == DEVICE_CONFIG_RECORD_SIZE;
+}
+
+static bool storageWrite(const uint8_t* record)
+{
+  Preferences prefs;
+  if (!prefs.begin("cbh", false)) {
+    return false;
+  }
+  size_t length = prefs.putBytes("config", record, DEVICE_CONFIG_RECORD_SIZE);
+  prefs.end();
+  return length == DEVICE_CONFIG_RECORD_SIZE;
+}
+
+#elif !defined(ARDUINO)
+
+static const char* config_path = "device_config.bin";
+
+void deviceConfigSetPath(const char* path)
+{
+  config_path = path;
+}
+
+static bool storageRead(uint8_t* record)
+{
+  FILE* f = fopen(config_path, "rb");
+  if (!f) {
+    return false;
+  }
+  size_t length = fread(record, 1, DEVICE_CONFIG_RECORD_SIZE, f);
+  fclose(f);
+  return length == DEVICE_CONFIG_RECORD_SIZE;
+}
+
+static bool storageWrite(const uint8_t* record)
+{
+  FILE* f = fopen(config_path, "wb");
+  if (!f) {
+    return false;
+  }
+  size_t length = fwrite(record, 1, DEVICE_CONFIG_RECORD_SIZE, f);
+  return fclose(f) == 0 && length == DEVICE_CONFIG_RECORD_SIZE;
+}
+
+#else
+
+static bool storageRead(uint8_t* record)
+{
+  (void)record;
+  return false;
+}
+
+static bool storageWrite(const uint8_t* record)
+{
+  (void)record;
+  return false;
+}
+
+#endif
+
+bool deviceConfigLoad(DeviceConfig* config)
+{
+  deviceConfigDefaults(config);
+  uint8_t record[DEVICE_CONFIG_RECORD_SIZE];
+  return storageRead(record) && deviceConfigDecode(record, config);
+}
+
+bool deviceConfigSave(const DeviceConfig* config)
+{
+  uint8_t record[DEVICE_CONFIG_RECORD_SIZE];
+  deviceConfigEncode(config, record);
+  return storageWrite(record);
+}
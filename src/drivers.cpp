@@ -0,0 +1,18 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "drivers.h"
+
+// State of the mock drivers; dropped by the linker when they are not used
+const RGBColor* Sensor<MockSensor>::samples = nullptr;
+uint16_t Sensor<MockSensor>::count = 0;
+uint16_t Sensor<MockSensor>::next = 0;
+
+const unsigned char* Display<MockDisplay>::bitmap = nullptr;
+char Display<MockDisplay>::text[24];
+uint32_t Display<MockDisplay>::frames = 0;
@@ -0,0 +1,150 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "loop_profile.h"
+#include "pgm_compat.h"
+
+void loopProfileReset(LoopProfile* profile, uint16_t ticksPerUs, uint32_t now)
+{
+  for (uint8_t s = 0; s < LOOP_STAGE_COUNT; s++) {
+    for (uint8_t b = 0; b < LOOP_PROFILE_BINS; b++) {
+      profile->bins[s][b] = 0;
+    }
+    profile->maxTicks[s] = 0;
+  }
+  profile->lapStart = now;
+  profile->cycleStart = 0;
+  profile->ticksPerUs = ticksPerUs;
+}
+
+uint8_t loopProfileBin(uint32_t ticks)
+{
+  uint8_t bits = 0;
+  while (ticks) {
+    ticks >>= 1;
+    bits++;
+  }
+  return bits < LOOP_PROFILE_BINS ? bits : LOOP_PROFILE_BINS - 1;
+}
+
+uint32_t loopProfileBinTop(uint8_t bin)
+{
+  if (bin >= LOOP_PROFILE_BINS - 1) {
+    return 0xFFFFFFFF;
+  }
+  return ((uint32_t)1 << bin) - 1;
+}
+
+void loopProfileAdd(LoopProfile* profile, LoopStage stage, uint32_t ticks)
+{
+  uint16_t* count = &profile->bins[stage][loopProfileBin(ticks)];
+  if (*count != 0xFFFF) {
+    (*count)++;
+  }
+  if (ticks > profile->maxTicks[stage]) {
+    profile->maxTicks[stage] = ticks;
+  }
+}
+
+void loopProfileLap(LoopProfile* profile, LoopStage stage, uint32_t now)
+{
+  // Unsigned difference: right across a wrap of the counter
+  loopProfileAdd(profile, stage, now - profile->lapStart);
+  profile->lapStart = now;
+}
+
+void loopProfileReading(LoopProfile* profile, uint32_t now)
+{
+  if (profile->cycleStart != 0) {
+    loopProfileAdd(profile, LOOP_CYCLE, now - profile->cycleStart);
+  }
+  profile->cycleStart = now ? now : 1;
+}
+
+uint32_t loopProfileCount(const LoopProfile* profile, LoopStage stage)
+{
+  uint32_t total = 0;
+  for (uint8_t b = 0; b < LOOP_PROFILE_BINS; b++) {
+    total += profile->bins[stage][b];
+  }
+  return total;
+}
+
+uint32_t loopProfilePercentile(const LoopProfile* profile, LoopStage stage, uint8_t percent)
+{
+  uint32_t total = loopProfileCount(profile, stage);
+  if (total == 0) {
+    return 0;
+  }
+  // Smallest bin with at least percent of the counts at or below it
+  uint32_t needed = (total * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < LOOP_PROFILE_BINS; b++) {
+    seen += profile->bins[stage][b];
+    if (seen >= needed) {
+      uint32_t top = loopProfileBinTop(b);
+      return top < profile->maxTicks[stage] ? top : profile->maxTicks[stage];
+    }
+  }
+  return profile->maxTicks[stage];
+}
+
+static const char loop_name_sensor[] PROGMEM = "sensor";
+static const char loop_name_match[] PROGMEM = "match";
+static const char loop_name_render[] PROGMEM = "render";
+static const char loop_name_flush[] PROGMEM = "flush";
+static const char loop_name_serial[] PROGMEM = "serial";
+static const char loop_name_wait[] PROGMEM = "wait";
+static const char loop_name_other[] PROGMEM = "other";
+static const char loop_name_cycle[] PROGMEM = "cycle";
+static const char loop_name_unknown[] PROGMEM = "?";
+
+static const char* const loop_stage_names[LOOP_STAGE_COUNT] PROGMEM = {
+  loop_name_sensor, loop_name_match, loop_name_render, loop_name_flush,
+  loop_name_serial, loop_name_wait, loop_name_other, loop_name_cycle
+};
+
+const char* loopStageName(LoopStage stage)
+{
+  if (stage >= LOOP_STAGE_COUNT) {
+    return loop_name_unknown;
+  }
+  return (const char*)pgm_read_ptr(&loop_stage_names[stage]);
+}
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+
+uint32_t loopProfileNow()
+{
+  return ESP.getCycleCount();
+}
+
+uint16_t loopProfileTicksPerUs()
+{
+  return getCpuFrequencyMhz();
+}
+
+#else
+
+uint32_t loopProfileNow()
+{
+  return micros();
+}
+
+uint16_t loopProfileTicksPerUs()
+{
+  return 1;
+}
+
+#endif
+
+#endif
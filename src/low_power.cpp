@@ -0,0 +1,125 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "low_power.h"
+
+#if defined(ARDUINO) && defined(LOW_POWER)
+
+#include <Arduino.h>
+
+#if defined(__AVR__)
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+// Watchdog periods WDTO_15MS..WDTO_8S, nominal 16 ms << n
+#define WDT_STEPS 10
+
+static volatile bool wake_pin_fired;
+
+ISR(WDT_vect)
+{
+  wdt_disable();
+}
+
+static void wakePinIsr()
+{
+  wake_pin_fired = true;
+}
+
+static void powerDown(uint8_t wdto)
+{
+  cli();
+  MCUSR &= ~(1 << WDRF);
+  // Timed sequence: interrupt only, no reset
+  WDTCSR = (1 << WDCE) | (1 << WDE);
+  WDTCSR = (1 << WDIE) | (wdto & 0x07) | ((wdto & 0x08) ? (1 << WDP3) : 0);
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  sei();
+  sleep_cpu();
+  sleep_disable();
+  wdt_disable();
+}
+
+uint16_t lowPowerSleepMs(uint16_t ms, int8_t wakePin)
+{
+  uint16_t slept = 0;
+  wake_pin_fired = false;
+  if (wakePin >= 0) {
+    attachInterrupt(digitalPinToInterrupt(wakePin), wakePinIsr, LOW);
+  }
+  while (ms >= 16 && !wake_pin_fired) {
+    uint8_t wdto = 0;
+    while (wdto + 1 < WDT_STEPS && (16u << (wdto + 1)) <= ms) {
+      wdto++;
+    }
+    powerDown(wdto);
+    ms -= 16u << wdto;
+    slept += 16u << wdto;
+  }
+  // The rest in idle mode, Timer0 wakes the CPU every millisecond
+  unsigned long start = millis();
+  while (!wake_pin_fired && millis() - start < ms) {
+    lowPowerIdle();
+  }
+  if (wakePin >= 0) {
+    detachInterrupt(digitalPinToInterrupt(wakePin));
+  }
+  return slept;
+}
+
+void lowPowerIdle()
+{
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_mode();
+}
+
+#elif defined(ESP32)
+
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+
+uint16_t lowPowerSleepMs(uint16_t ms, int8_t wakePin)
+{
+  esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+  if (wakePin >= 0) {
+    gpio_wakeup_enable((gpio_num_t)wakePin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+  }
+  esp_light_sleep_start();
+  if (wakePin >= 0) {
+    gpio_wakeup_disable((gpio_num_t)wakePin);
+  }
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+  return 0;
+}
+
+void lowPowerIdle()
+{
+  // Entering light sleep costs about as much as a tick: let the idle task wait instead
+  delay(1);
+}
+
+#else
+
+uint16_t lowPowerSleepMs(uint16_t ms, int8_t wakePin)
+{
+  (void)wakePin;
+  delay(ms);
+  return 0;
+}
+
+void lowPowerIdle()
+{
+}
+
+#endif
+
+#endif
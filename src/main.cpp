@@ -27,27 +27,98 @@
 
 
 #include <Adafruit_TCS34725.h>
+#include "rle_decoder.h"
 #if defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
   #include <U8g2lib.h>
-  #include "small_bitmap.h"
+  #include <Wire.h>
+  #ifdef BITMAP_RLE
+    #include "small_bitmap_rle.h"
+  #else
+    #include "small_bitmap.h"
+  #endif
 #else
-  #include <Adafruit_GFX.h>
-  #include <Adafruit_SSD1306.h>
-  #include "bitmap.h"
+  #include <Wire.h>
+  #ifdef COLORBLINDHELPER_PAGED_OLED
+    #include "ssd1306_paged.h"
+  #else
+    #include <Adafruit_GFX.h>
+    #include <Adafruit_SSD1306.h>
+  #endif
+  #ifdef BITMAP_RLE
+    #include "bitmap_rle.h"
+  #else
+    #include "bitmap.h"
+  #endif
 #endif
 
-#include "ita_string.h"
+// Language pack, -DLANGUAGE_EN or -DLANGUAGE_ES in build_flags, Italian otherwise
+#if defined(LANGUAGE_EN)
+  #include "eng_string.h"
+#elif defined(LANGUAGE_ES)
+  #include "spa_string.h"
+#else
+  #include "ita_string.h"
+#endif
+#include "class_table.h"
+#include "color_match.h"
+#include "tcs3200_capture.h"
+#include "tcs34725_async.h"
+#include "sample_pipeline.h"
+#include "drivers.h"
+#include "render_cache.h"
+#include "telemetry.h"
+#include "device_config.h"
+#include "boot_profile.h"
+#include "low_power.h"
+#include "mem_stats.h"
+#include "loop_profile.h"
+#include "color_sweep.h"
+#ifdef COLOR_MATCH_PALETTE
+  #include "palette_css.h"
+#endif
+#ifdef ESP32
+  // PIPELINED_TASKS, defined below
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
+  #include <freertos/task.h>
+  #include "render_mailbox.h"
+#endif
 
 #define ENABLE_DISPLAY
 #define ENABLE_SENSOR
 //#define CALIBRATION_MODE
+#define STABLE_DETECTION          // median filter + hysteresis instead of a fixed delay
+#define SAMPLE_INTERVAL_MS 10     // pause between two samples with STABLE_DETECTION
+//#define BURST_SAMPLING            // one answer from a burst of readings, longer only on ambiguous colors
+//#define TELEMETRY                 // binary frames per sample (tools/telemetry_decode.py) instead of text
+#define TELEMETRY_BAUD 115200
+#define FAST_BOOT                 // sensor integrating while the display starts, no fixed display delay
+#define BOOT_PROFILE              // time of each init stage up to the first result (telemetry or text)
+#define OLED_READY_TIMEOUT_MS 1000
+#define SENSOR_OFF_MIN_MS 50      // LOW_POWER (low_power.h): shorter pauses keep the sensor on (wake-up costs a new integration)
+//#define SENSOR_LED_PIN 3          // pin switching the sensor LED, off while idle
+//#define PIPELINED_TASKS           // ESP32: display in its own FreeRTOS task, the sensor integrates while a frame is sent
+//#define MEM_STATS                 // stack painted at boot, 'M' on the serial port reports free RAM and stack high-water mark
+//#define LOOP_PROFILE              // time of each loop() stage in log2 histograms, 'L' on the serial port prints them
+//#define SWEEP_MODE                // sweep across stripes: readings as fast as the sensor goes, the sequence of colors shown when lifted
+#define SWEEP_END_MS 300          // nothing but undefined for this long: the sensor was lifted, the sweep is over
+#define SWEEP_TEXT_SIZE 48
+
+#if !defined(TELEMETRY) && !defined(SWEEP_MODE)
+  #define SERIAL_TEXT_LOG           // sample values and color names as text on the serial port
+#endif
 
 //sensor type define
 #ifdef ENABLE_SENSOR
   //#define TCS3200
   #define TCS34725
+  #ifdef TCS34725
+    //#define TCS34725_ASYNC      // non-blocking reads with automatic integration time and gain
+  #endif
   #ifdef TCS3200
     //#define CALIBRATION_MODE
+    //#define TCS3200_CAPTURE     // background reading with Timer1 input capture (Nano only)
+    #define TCS3200_GATE_MS 20    // capture time for each color filter
   #endif
   //#define TEST_SENSOR
 #endif
@@ -56,6 +127,31 @@
 #if defined(ENABLE_SENSOR) && defined(TCS3200) && defined(TCS34725)
   #error Choose TCS3200 or TCS34725. It cannot reads both sensor at the same time.
 #endif
+#if defined(TCS3200_CAPTURE) && !defined(__AVR_ATmega328P__)
+  #error TCS3200_CAPTURE needs the Timer1 input capture of the ATmega328 (OUT on D8).
+#endif
+#if defined(STABLE_DETECTION) && defined(BURST_SAMPLING)
+  #error Choose STABLE_DETECTION or BURST_SAMPLING, both filter the readings.
+#endif
+#if defined(PIPELINED_TASKS) && !defined(ESP32)
+  #error PIPELINED_TASKS needs FreeRTOS, ESP32 only.
+#endif
+#if defined(PIPELINED_TASKS) && defined(ENABLE_SENSOR) && defined(TCS34725) && !defined(TCS34725_ASYNC)
+  #error PIPELINED_TASKS needs TCS34725_ASYNC, the blocking read keeps the I2C bus during the whole integration.
+#endif
+#if defined(LOW_POWER) && defined(TCS3200_CAPTURE)
+  #error LOW_POWER stops Timer1 in power-down, TCS3200_CAPTURE cannot run with it.
+#endif
+#if defined(SWEEP_MODE) && defined(TCS34725_ASYNC)
+  #error SWEEP_MODE needs the short fixed integration of the blocking TCS34725 read, TCS34725_ASYNC lengthens it on dark colors.
+#endif
+
+// Wake from sleep at the end of an integration, otherwise only the timer does
+#if defined(TCS34725_ASYNC) && defined(TCS34725_INT_PIN)
+  #define INTEGRATION_WAKE_PIN TCS34725_INT_PIN
+#else
+  #define INTEGRATION_WAKE_PIN -1
+#endif
 
 
 // PIN for TCS3200 sensor
@@ -70,320 +166,752 @@
 // esp32 c3 oled def
 #if defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
   const int OLED_WIDTH = 72, OLED_HEIGHT = 40, X_OFFSET = 28, Y_OFFSET = 32;
-  U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, U8X8_PIN_NONE, 6, 5);
+  #define OLED042_SDA 5
+  #define OLED042_SCL 6
+  U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, U8X8_PIN_NONE, OLED042_SCL, OLED042_SDA);
   #define BITMAP_SIZE 20
 #else 
     // Display object
   #ifdef ENABLE_DISPLAY
     #define SCREEN_WIDTH 128 // OLED display width, in pixels
     #define SCREEN_HEIGHT 64 // OLED display height, in pixels
-    Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT);
+    #ifndef COLORBLINDHELPER_PAGED_OLED
+      Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT);
+    #endif
   #endif
   #define BITMAP_SIZE 40
 #endif
+#define DISPLAY_FRAME_BYTES (128 * 64 / 8)  // a full 128x64 frame on both displays
 
-typedef struct {
-  uint8_t r, g, b;
-} RGBColor;
-
-typedef enum {
-    COL_UNDEFINED = -1,
-    COL_GRAY,
-    COL_RED,
-    COL_YELLOW,
-    COL_GREEN,
-    COL_BLUE,
-    COL_BROWN,
-    COL_ORANGE,
-    COL_PURPLE,
-    COL_PINK,
-    COL_AZURE
-} ColorClass;
-
-typedef struct {
-  RGBColor reference_color;
-  ColorClass color_class;
-} ColoReference;
-
-//Calibrate this value with your specific sensor
-#if defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
-const ColoReference color_reference[] = {
-  {{50,   50,   50},  COL_GRAY},    // GRAY
-  {{155,  53,   41},  COL_RED},     // RED
-  {{147,  44,   44},  COL_RED},     // RED Dark
-  {{151,  53,   39},  COL_RED},     // RED Light
-  {{125,   80,  30},  COL_YELLOW},  // YELLOW
-  {{130,  76,  32},  COL_YELLOW},  // YELLOW Dark
-  {{118,  87,  30},  COL_YELLOW},  // YELLOW Light
-  {{72,   107,  55},  COL_GREEN},   // GREEN 
-  {{71,   97,  68},  COL_GREEN},   // GREEN Dark
-  {{72,   112,  47},  COL_GREEN},   // GREEN Light
-  {{61,   81,   93}, COL_BLUE},    // BLU dark
-  {{57,   82,   96}, COL_BLUE},    // BLU light
-  {{125,   73,   41},  COL_BROWN},   // BROWN
-  {{124,   70,   44},  COL_BROWN},   // BROWN dark
-  {{119,   79,   43},  COL_BROWN},   // BROWN light
-  {{144,  64,   34},  COL_ORANGE},  // ORANGE 
-  {{148,  59,   35},  COL_ORANGE},  // ORANGE dark
-  {{138,  70,   33},  COL_ORANGE},  // ORANGE light
-  {{74,   69,   94}, COL_PURPLE},  // PURPLE 
-  {{128,   54,   62}, COL_PURPLE},  // PURPLE light
-  {{118,   66,   56},  COL_PINK},    // PINK
-  {{114,   85,   59},  COL_PINK},    // PINK light
-  {{60,   88,   93}, COL_AZURE},    // AZURE 
-  {{52,   91,  97}, COL_AZURE}    // AZURE scuro
-};
-#else
-const ColoReference color_reference[] = {
-  {{50,   50,   50},  COL_GRAY},    // GRAY
-  {{112,  79,   71},  COL_RED},     // RED
-  {{108,  78,   73},  COL_RED},     // RED Dark
-  {{120,  76,   66},  COL_RED},     // RED Light
-  {{92,   106,  50},  COL_YELLOW},  // YELLOW
-  {{104,  100,  51},  COL_YELLOW},  // YELLOW Dark
-  {{57,   115,  85},  COL_GREEN},   // GREEN 
-  {{53,   109,  95},  COL_GREEN},   // GREEN Dark
-  {{77,   117,  71},  COL_GREEN},   // GREEN Light
-  {{51,   96,   107}, COL_BLUE},    // BLU dark
-  {{43,   95,   119}, COL_BLUE},    // BLU light
-  {{95,   92,   70},  COL_BROWN},   // BROWN
-  {{91,   93,   70},  COL_BROWN},   // BROWN dark
-  {{95,   92,   66},  COL_BROWN},   // BROWN light
-  {{113,  87,   60},  COL_ORANGE},  // ORANGE 
-  {{117,  82,   62},  COL_ORANGE},  // ORANGE dark
-  {{111,  90,   56},  COL_ORANGE},  // ORANGE light
-  {{53,   85,   117}, COL_PURPLE},  // PURPLE 
-  {{95,   76,   90}, COL_PURPLE},  // PURPLE light
-  {{85,   93,   80},  COL_PINK},    // PINK
-  {{90,   84,   85},  COL_PINK},    // PINK dark
-  {{76,   95,   86},  COL_PINK},    // PINK light
-  {{41,   98,   117}, COL_AZURE},    // AZURE 
-  {{38,   100,  119}, COL_AZURE}    // AZURE scuro
-};
-#endif
+// Serial commands of configCommand(), the record is stored by device_config.h
+#define CONFIG_CMD_WHITE 'W'      // sensor on a white surface: TCS3200 minimums, TCS34725 gain
+#define CONFIG_CMD_BLACK 'K'      // sensor on a black surface: TCS3200 maximums
+#define CONFIG_CMD_UPLOAD 'U'     // followed by a DEVICE_CONFIG_RECORD_SIZE record (tools/device_config.py)
+#define CONFIG_CMD_RESET 'X'      // back to the built-in values
+#define CONFIG_CMD_MEMORY 'M'     // MEM_STATS: memory report, nothing is changed
+#define CONFIG_CMD_PROFILE 'L'    // LOOP_PROFILE: stage histograms, then cleared
+#define CONFIG_CALIBRATION_READS 8
 
-
-// Value for calibration of the TCS3200. White surface and black surface
-int redMin = 0;   
-int redMax = 0;
-int greenMin = 0;
-int greenMax = 0;
-int blueMin = 0;
-int blueMax = 0;
+// Calibration of the TCS3200 (white and black surface), TCS34725 gain and
+// reference table of this unit, loaded in setup()
+DeviceConfig device_config;
 
 // Function definition
-void drawBitmapWithText(const unsigned char* bitmap, int bmp_width, int bmp_height, const char* message);
-ColorClass bestMatchRGB(RGBColor currentColor);
+void drawBitmapWithText(const unsigned char* bitmap, int bmp_width, int bmp_height, const char* message, int16_t textWidth);
 void rawSesnsorRead();
 RGBColor rgbSensorReadTCS3200();
+bool rgbSensorReadTCS3200Capture(RGBColor* color);
 RGBColor readRGBColorTCS34725();
+bool readRGBColorTCS34725Async(RGBColor* color);
 void drawRGBText(unsigned char r, unsigned char g, unsigned char b);
+void ssd1306FlushPages(uint8_t first, uint8_t last);
+void drawRleBitmap(int x, int y, const unsigned char* asset);
+void telemetryRaw(uint16_t r, uint16_t g, uint16_t b, uint16_t c);
+void telemetrySend(RGBColor color, ColorClass col, uint32_t distance);
+void configApply();
+void configCommand();
+void memReport();
+void loopReport();
+void loopLap(LoopStage stage);
+void sweepStep(ColorClass col);
+void sweepReport();
+void tcs3200MeasurePulses(int16_t pulses[3]);
+void sensorBegin();
+void displayBegin();
+bool oledWaitReady(uint16_t timeoutMs);
+void bootStage(BootStage stage);
+void sampleWait(uint16_t ms);
+void integrationWait();
+void sensorSleep();
+void sensorWake();
+void drawColorClass(ColorClass col);
+void renderPost(const PipelineResult* result);
+void renderTask(void* arg);
+void busLock();
+void busUnlock();
 
 // Sensor object
 #if defined(ENABLE_SENSOR) && defined(TCS34725)
   Adafruit_TCS34725 tcs = Adafruit_TCS34725();
 #endif
 
-// Setup of the ARDUINO NANO with pin init
-void setup() 
-{
-  Serial.begin(9600);
-  Serial.println("Running");
-#if defined(ENABLE_SENSOR) && defined(TCS3200)
-  pinMode(S0, OUTPUT);
-  pinMode(S1, OUTPUT);
-  pinMode(S2, OUTPUT);
-  pinMode(S3, OUTPUT);
-  pinMode(OUT, INPUT);
-  digitalWrite(S0, HIGH);
-  digitalWrite(S1, LOW);
-#endif
+// Filter, classification and redraw decision of every reading
+SamplePipeline sample_pipeline;
 
 #ifdef ENABLE_DISPLAY
-  #if defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
+  RenderCache render_cache;
+#endif
+
+#ifdef TELEMETRY
+  TelemetrySample telemetry_sample;
+#endif
+
+#ifdef BOOT_PROFILE
+  BootProfile boot_profile;
+#endif
+
+#ifdef LOOP_PROFILE
+  LoopProfile loop_profile;
+#endif
+
+#ifdef SWEEP_MODE
+  ColorSweep color_sweep;
+  uint32_t sweep_last_ms;
+#endif
+
+#ifdef PIPELINED_TASKS
+  // loop() reads and classifies, renderTask() draws the latest result
+  RenderMailbox render_mailbox;
+  TaskHandle_t render_task = nullptr;
+  // Sensor and display share one I2C bus, each transfer takes it whole
+  SemaphoreHandle_t i2c_bus = nullptr;
+  #define RENDER_TASK_STACK 4096
+  #define RENDER_TASK_PRIORITY 2  // above loop(): a new result starts its flush at once
+#endif
+
+// Sensor drivers (drivers.h), only the selected one is compiled
+#if defined(ENABLE_SENSOR) && defined(TCS34725)
+template <> struct Sensor<Tcs34725> {
+  static void begin() {
+    // Sensor init for TCS34725 (GY-33) with I2C
+    if (!tcs.begin()) {
+      Serial.print(F("No sensor"));
+      // If no sensor found stop the program in a loop
+      while (true);
+    }
+  #ifdef TCS34725_ASYNC
+    tcs34725AsyncBegin(tcs);
+  #else
+    tcs.setGain((tcs34725Gain_t)device_config.tcs34725Gain);
+  #endif
+  }
+  static bool read(RGBColor* color) {
+  #ifdef TCS34725_ASYNC
+    return readRGBColorTCS34725Async(color);
+  #else
+    *color = readRGBColorTCS34725();
+    return true;
+  #endif
+  }
+  static void sleep() {
+  #ifdef TCS34725_ASYNC
+    tcs34725AsyncSleep(tcs);
+  #else
+    tcs.disable();
+  #endif
+  }
+  static void wake() {
+  #ifdef TCS34725_ASYNC
+    tcs34725AsyncWake(tcs);
+  #else
+    tcs.enable();     // waits for the warm-up and one integration
+  #endif
+  }
+};
+typedef Sensor<Tcs34725> SensorDriver;
+#elif defined(ENABLE_SENSOR) && defined(TCS3200)
+template <> struct Sensor<Tcs3200> {
+  static void begin() {
+    pinMode(S0, OUTPUT);
+    pinMode(S1, OUTPUT);
+    pinMode(S2, OUTPUT);
+    pinMode(S3, OUTPUT);
+    pinMode(OUT, INPUT);
+    digitalWrite(S0, HIGH);
+    digitalWrite(S1, LOW);
+  #if defined(TCS3200_CAPTURE) && !defined(CALIBRATION_MODE)
+    tcs3200CaptureBegin(TCS3200_GATE_MS);
+  #endif
+  }
+  static bool read(RGBColor* color) {
+  #ifdef TCS3200_CAPTURE
+    bool ready = rgbSensorReadTCS3200Capture(color);  // false while Timer1 is still measuring
+  #else
+    *color = rgbSensorReadTCS3200();
+    bool ready = true;
+  #endif
+    loopLap(LOOP_SENSOR);
+    return ready;
+  }
+  static void sleep() {
+    // S0 = S1 = LOW is the power down mode of the TCS3200
+    digitalWrite(S0, LOW);
+  }
+  static void wake() {
+    digitalWrite(S0, HIGH);
+  }
+};
+typedef Sensor<Tcs3200> SensorDriver;
+#else
+// No sensor: always the same reading
+static const RGBColor fixed_reading[] = {{112, 79, 71}};
+typedef Sensor<MockSensor> SensorDriver;
+#endif
+
+// Display drivers (drivers.h), only the selected one is compiled
+#if defined(ENABLE_DISPLAY) && defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
+template <> struct Display<U8g2Oled042> {
+  static void begin() {
+  #ifdef FAST_BOOT
+    oledWaitReady(OLED_READY_TIMEOUT_MS);
+  #else
     delay(1000);              // raccomanded from some exaple
+  #endif
     u8g2.begin();
     u8g2.setContrast(255);    // best visibility
     u8g2.setBusClock(400000); 
+  }
+  // Proportional font: drawColorClass() measures each name once
+  static constexpr int16_t nameWidth(uint8_t) {
+    return TEXT_WIDTH_MEASURE;
+  }
+  static int16_t textWidth(const char* message) {
+    u8g2.setFont(u8g2_font_ncenB08_tr);
+    return u8g2.getStrWidth(message);
+  }
+  static uint16_t draw(const unsigned char* bitmap, uint8_t bmp_width, uint8_t bmp_height, const char* message,
+                       int16_t textWidth, RenderAction action) {
+    // --- PER OLED 0.42" su ESP32-C3/U8G2 ---
+    u8g2.clearBuffer();
+
+    // Bitmap centrata nell'area visibile con offset
+    int x_bmp = X_OFFSET + (OLED_WIDTH  - bmp_width) / 2;
+    int y_bmp = Y_OFFSET;
+  #ifdef BITMAP_RLE
+    drawRleBitmap(x_bmp, y_bmp, bitmap);
   #else
+    u8g2.drawXBMP(x_bmp, y_bmp, bmp_width, bmp_height, bitmap);
+  #endif
+
+    // Testo centrato sotto la bitmap
+    u8g2.setFont(u8g2_font_ncenB08_tr);
+    if (textWidth == TEXT_WIDTH_MEASURE) {
+      textWidth = u8g2.getStrWidth(message);
+    }
+    int x_text = X_OFFSET + (OLED_WIDTH - textWidth) / 2;
+    int y_text = Y_OFFSET + OLED_HEIGHT - 8 -1;
+
+    u8g2.drawStr(x_text, y_text, message);
+
+    loopLap(LOOP_RENDER);
+    if (action == RENDER_TEXT) {
+      // Only the tile rows (8 pixels each) from the top of the text down
+      uint8_t firstTile = (y_text - u8g2.getAscent()) / 8;
+      busLock();
+      u8g2.updateDisplayArea(0, firstTile, 128 / 8, 64 / 8 - firstTile);
+      busUnlock();
+      loopLap(LOOP_FLUSH);
+      return (64 / 8 - firstTile) * 128;
+    }
+    busLock();
+    u8g2.sendBuffer();
+    busUnlock();
+    loopLap(LOOP_FLUSH);
+    return DISPLAY_FRAME_BYTES;
+  }
+  static void drawRGB(RGBColor color) {
+    u8g2.clearBuffer();
+    // Testo centrato sotto la bitmap
+    u8g2.setFont(u8g2_font_ncenB08_tr);
+    int x_text = X_OFFSET;
+    int y_text = Y_OFFSET + OLED_HEIGHT - (9*3);
+    char buffer[8];
+    sprintf(buffer,"r: %d",color.r);
+    u8g2.drawStr(x_text, y_text, buffer);
+
+    y_text = Y_OFFSET + OLED_HEIGHT - (9*2);
+    sprintf(buffer,"g: %d",color.g);
+    u8g2.drawStr(x_text, y_text, buffer);
+
+    y_text = Y_OFFSET + OLED_HEIGHT - (9);
+    sprintf(buffer,"b: %d",color.b);
+    u8g2.drawStr(x_text, y_text, buffer);
+
+    busLock();
+    u8g2.sendBuffer();
+    busUnlock();
+  }
+};
+typedef Display<U8g2Oled042> DisplayDriver;
+  #define DISPLAY_PROPORTIONAL_FONT
+#elif defined(ENABLE_DISPLAY) && defined(COLORBLINDHELPER_PAGED_OLED)
+template <> struct Display<Ssd1306Paged> {
+  static void begin() {
+    // Display init and clear, no framebuffer
+    if (!ssd1306PagedBegin(OLED_ADDR)) {
+      Serial.print(F("No Display"));
+      while (true); // If no display found stop the program in a loop
+    }
+  }
+  static constexpr int16_t nameWidth(uint8_t chars) {
+    return PAGE_TEXT_WIDTH(chars, 2);
+  }
+  static uint16_t draw(const unsigned char* bitmap, uint8_t bmp_width, uint8_t bmp_height, const char* message,
+                       int16_t textWidth, RenderAction action) {
+    // --- PER DISPLAY CLASSICO, una pagina alla volta ---
+    PageFrame frame;
+    uint8_t textFirst, textLast;
+    pageLayout(&frame, bitmap, bmp_width, bmp_height, message, ssd1306_paged_font, textWidth, &textFirst, &textLast);
+  #ifdef BITMAP_RLE
+    RleDecoder rle;
+    if (bitmap) {
+      rleBegin(&rle, bitmap);
+      frame.rle = &rle;
+    }
+  #endif
+
+    renderCacheTextPages(&render_cache, &textFirst, &textLast);
+    uint8_t firstPage = 0;
+    uint8_t lastPage = PAGE_COUNT - 1;
+    if (action == RENDER_TEXT) {
+      // Only the pages (8 pixel rows) under the new and the previous text
+      firstPage = textFirst;
+      lastPage = textLast;
+    }
+    loopLap(LOOP_RENDER);
+    ssd1306PagedDraw(&frame, firstPage, lastPage);   // each page rendered, then sent
+    loopLap(LOOP_FLUSH);
+    return (lastPage - firstPage + 1) * SCREEN_WIDTH;
+  }
+  static void drawRGB(RGBColor color) {
+    char buffer[12];
+    snprintf_P(buffer, sizeof(buffer), PSTR("%d %d %d"), color.r, color.g, color.b);
+    draw(nullptr, 0, 0, buffer, TEXT_WIDTH_MEASURE, RENDER_FULL);
+  }
+};
+typedef Display<Ssd1306Paged> DisplayDriver;
+#elif defined(ENABLE_DISPLAY)
+template <> struct Display<Ssd1306> {
+  static void begin() {
     // Display init
     if (!display.begin( SSD1306_SWITCHCAPVCC, 0x3C, true)) {
-      Serial.print("No Display");
+      Serial.print(F("No Display"));
       while (true); // If no display found stop the program in a loop
     }
       // Buffer clear
     display.clearDisplay();
     // Apply to display
     display.display();
+  }
+  // Classic 6x8 font at text size 2
+  static constexpr int16_t nameWidth(uint8_t chars) {
+    return chars * 12;
+  }
+  static uint16_t draw(const unsigned char* bitmap, uint8_t bmp_width, uint8_t bmp_height, const char* message,
+                       int16_t textWidth, RenderAction action) {
+    // --- PER DISPLAY CLASSICO Adafruit SSD1306 ---
+    display.clearDisplay();
+    int x_bmp = (display.width() - bmp_width) / 2;
+    int y_bmp = 0;
+  #ifdef BITMAP_RLE
+    drawRleBitmap(x_bmp, y_bmp, bitmap);
+  #else
+    display.drawBitmap(x_bmp, y_bmp, bitmap, bmp_width, bmp_height, WHITE);
   #endif
-#endif
 
-#if defined(ENABLE_SENSOR) && defined(TCS34725)
-  // Sensor init for TCS34725 (GY-33) with I2C
-  if (!tcs.begin()) {
-    Serial.print("No sensor");
-    // If no sensor found stop the program in a loop
-    while (true);
+    display.setTextSize(2); // o regola secondo font desiderato
+    display.setTextColor(WHITE);
+    uint16_t w = textWidth, h = 16;
+    if (textWidth == TEXT_WIDTH_MEASURE) {
+      int16_t x1, y1;
+      display.getTextBounds(message, 0, 0, &x1, &y1, &w, &h);
+    }
+    int x_text = (display.width() - w) / 2;
+    int y_text = bmp_height + ((display.height() - bmp_height - 16) / 2);
+
+    display.setCursor(x_text, y_text);
+    display.print(message);
+    uint8_t firstPage = y_text / 8;
+    uint8_t lastPage = min(y_text + h - 1, SCREEN_HEIGHT - 1) / 8;
+    renderCacheTextPages(&render_cache, &firstPage, &lastPage);
+    loopLap(LOOP_RENDER);
+    if (action == RENDER_TEXT) {
+      // Only the pages (8 pixel rows) under the new and the previous text
+      ssd1306FlushPages(firstPage, lastPage);
+      loopLap(LOOP_FLUSH);
+      return (lastPage - firstPage + 1) * SCREEN_WIDTH;
+    }
+    display.display();
+    loopLap(LOOP_FLUSH);
+    return DISPLAY_FRAME_BYTES;
   }
-  tcs.setGain(TCS34725_GAIN_16X);
+  static void drawRGB(RGBColor color) {
+    display.clearDisplay();
+    display.setTextSize(1);
+    display.setTextColor(WHITE);
+    display.setCursor(0, 0);
+    display.print(F("r: "));
+    display.println(color.r);
+    display.print(F("g: "));
+    display.println(color.g);
+    display.print(F("b: "));
+    display.println(color.b);
+    display.display();
+  }
+};
+typedef Display<Ssd1306> DisplayDriver;
+#else
+typedef Display<MockDisplay> DisplayDriver;
+#endif
+
+// Icon, name and name width of every class, in flash (class_table.h)
+static const ClassDescriptor class_descriptors[COLOR_CLASS_COUNT + 1] PROGMEM =
+    CLASS_DESCRIPTOR_TABLE(DisplayDriver::nameWidth);
+
+// Setup of the ARDUINO NANO with pin init
+void setup() 
+{
+#ifdef MEM_STATS
+  memStatsBegin();
+#endif
+#ifdef BOOT_PROFILE
+  bootProfileReset(&boot_profile);
+#endif
+  bootStage(BOOT_SETUP);
+#ifdef TELEMETRY
+  Serial.begin(TELEMETRY_BAUD);
+  telemetry_sample.seq = 0;
+  telemetryRaw(0, 0, 0, 0);
+#else
+  Serial.begin(9600);
+  Serial.println(F("Running"));
+#endif
+#if defined(SWEEP_MODE)
+  // Every reading classified as it comes, the sweep debounces the classes
+  samplePipelineReset(&sample_pipeline, PIPELINE_SINGLE);
+  colorSweepReset(&color_sweep);
+#elif defined(STABLE_DETECTION)
+  samplePipelineReset(&sample_pipeline, PIPELINE_STABLE);
+#elif defined(BURST_SAMPLING)
+  samplePipelineReset(&sample_pipeline, PIPELINE_BURST);
+#else
+  samplePipelineReset(&sample_pipeline, PIPELINE_SINGLE);
+#endif
+  deviceConfigLoad(&device_config);
+  configApply();
+  bootStage(BOOT_CONFIG);
+#if defined(ESP32) && defined(COLORBLINDHELPER_OLED042)
+  // Sensor and display share these pins; whoever calls Wire.begin() first sets them
+  Wire.begin(OLED042_SDA, OLED042_SCL);
+#endif
+#ifdef FAST_BOOT
+  // The first integration runs while the display starts
+  sensorBegin();
+  bootStage(BOOT_SENSOR);
+  displayBegin();
+  bootStage(BOOT_DISPLAY);
+#else
+  displayBegin();
+  bootStage(BOOT_DISPLAY);
+  sensorBegin();
+  bootStage(BOOT_SENSOR);
+#endif
+#ifdef PIPELINED_TASKS
+  renderMailboxReset(&render_mailbox);
+  i2c_bus = xSemaphoreCreateMutex();
+  xTaskCreate(renderTask, "render", RENDER_TASK_STACK, nullptr, RENDER_TASK_PRIORITY, &render_task);
+#endif
+#ifdef LOOP_PROFILE
+  loopProfileReset(&loop_profile, loopProfileTicksPerUs(), loopProfileNow());
+#endif
+}
+
+// Sensor init, the first integration is started here
+void sensorBegin()
+{
+#ifndef ENABLE_SENSOR
+  SensorDriver::load(fixed_reading, 1);
+#endif
+  SensorDriver::begin();
+#ifdef SENSOR_LED_PIN
+  pinMode(SENSOR_LED_PIN, OUTPUT);
+  digitalWrite(SENSOR_LED_PIN, HIGH);
 #endif
 }
 
+void displayBegin()
+{
+#ifdef ENABLE_DISPLAY
+  renderCacheReset(&render_cache);
+  DisplayDriver::begin();
+#endif
+}
+
+// Poll the display address until the controller acknowledges, at most
+// timeoutMs, instead of always waiting the worst case power-up time
+bool oledWaitReady(uint16_t timeoutMs)
+{
+  unsigned long start = millis();
+  do {
+    Wire.beginTransmission(OLED_ADDR);
+    if (Wire.endTransmission() == 0) {
+      return true;
+    }
+    delay(1);
+  } while (millis() - start < timeoutMs);
+  return false;
+}
+
 // Exec Loop
 void loop() 
 {
+  if (Serial.available()) {
+    configCommand();
+  }
+  loopLap(LOOP_OTHER);
+#if defined(ENABLE_SENSOR) && defined(TCS3200) && defined(CALIBRATION_MODE)
+  rawSesnsorRead(); //read of the calibration parameters (only first time)
+  return; //// exit from loop to avoid while at the end and read again
+#endif
+#ifdef COLOR_MATCH_PALETTE
   RGBColor curretColor;
-#ifdef ENABLE_SENSOR
-  #ifdef TCS3200
-    #ifdef CALIBRATION_MODE
-      rawSesnsorRead(); //read of the calibration parameters (only first time)
-      return; //// exit from loop to avoid while at the end and read again
-    #else
-      curretColor = rgbSensorReadTCS3200();
-    #endif
-  #elif defined(TCS34725)
-    curretColor = readRGBColorTCS34725();
+  if (!SensorDriver::read(&curretColor)) {
+    integrationWait();
+    return; // integration or capture still running
+  }
+  bootStage(BOOT_FIRST_SAMPLE);
+  // Fine-grained color names instead of the ColorClass buckets
+  uint32_t paletteDist;
+  int16_t entry = paletteNearest(&palette_css, curretColor, PALETTE_THRESHOLD, &paletteDist);
+  #ifdef SERIAL_TEXT_LOG
+    Serial.println(paletteDist);
   #endif
-#else
-  curretColor.r = 112;
-  curretColor.g = 79;
-  curretColor.b = 71;
+  char name[24];
+  paletteName(&palette_css, entry, name, sizeof(name));
+  if (entry == PALETTE_NO_MATCH) {
+    drawColorClass(COL_UNDEFINED);
+  } else {
+    drawBitmapWithText(nullptr, 0, 0, name, TEXT_WIDTH_MEASURE);
+  }
+  sampleWait(500);
+  return;
 #endif
   //Find nearest colo meatch
-  ColorClass col = bestMatchRGB(curretColor);
+  PipelineResult result;
+  if (!scanStep<SensorDriver>(&sample_pipeline, &result)) {
+    integrationWait();
+    return; // integration or capture still running
+  }
+  loopLap(LOOP_MATCH);
+  bootStage(BOOT_FIRST_SAMPLE);
+  if (!result.ready) {
+    return;   // BURST_SAMPLING: next reading of the burst right away
+  }
+#ifdef LOOP_PROFILE
+  loopProfileReading(&loop_profile, loopProfileNow());
+#endif
+  ColorClass col = result.colorClass;
+#ifdef SERIAL_TEXT_LOG
+  Serial.println(result.distance);
+  #ifdef BURST_SAMPLING
+    Serial.print(F("Readings: "));
+    Serial.print(result.readings);
+    Serial.print(F("  Confidence: "));
+    Serial.println(result.confidence);
+  #endif
+#endif
+  telemetrySend(result.color, col, result.distance);
+  loopLap(LOOP_SERIAL);
+#ifdef SWEEP_MODE
+  sweepStep(col);
+  return;   // next reading right away
+#endif
 #ifdef TEST_SENSOR
-  drawRGBText(curretColor.r,curretColor.g,curretColor.b);
+  drawRGBText(result.color.r, result.color.g, result.color.b);
   delay(500);
   return;
 #endif
-  switch(col) {
-    case COL_GRAY:
-      drawBitmapWithText(epd_bitmap_gray, BITMAP_SIZE, BITMAP_SIZE, GRAY_STR);
-      break;
-    case COL_RED:
-      drawBitmapWithText(epd_bitmap_red, BITMAP_SIZE, BITMAP_SIZE, RED_STR);
-      break;
-    case COL_YELLOW:
-      drawBitmapWithText(epd_bitmap_yellow, BITMAP_SIZE, BITMAP_SIZE, YELLOW_STR);
-      break;
-    case COL_BLUE:
-      drawBitmapWithText(epd_bitmap_blue, BITMAP_SIZE, BITMAP_SIZE, BLUE_STR);
-      break;
-    case COL_BROWN:
-      drawBitmapWithText(epd_bitmap_brown, BITMAP_SIZE, BITMAP_SIZE, BROWN_STR);
-      break;
-    case COL_ORANGE:
-      drawBitmapWithText(epd_bitmap_orange, BITMAP_SIZE,BITMAP_SIZE, ORANGESTR_STR);
-      break;
-    case COL_PURPLE:
-      drawBitmapWithText(epd_bitmap_purple, BITMAP_SIZE,BITMAP_SIZE, PURPLE_STR);
-      break;
-    case COL_PINK:
-      drawBitmapWithText(epd_bitmap_pink, BITMAP_SIZE, BITMAP_SIZE, PINK_STR);
-      break;
-    case COL_AZURE:
-      drawBitmapWithText(epd_bitmap_azure, BITMAP_SIZE, BITMAP_SIZE, AZURE_STR);
-      break;
-    case COL_GREEN:
-      drawBitmapWithText(epd_bitmap_green, BITMAP_SIZE, BITMAP_SIZE, GREEN_STR);
-      break;
-    default:
-      drawBitmapWithText(nullptr, 0, 0, "?????");
-      ;
+  if (!result.show) {
+    // No new class confirmed by consecutive samples (STABLE_DETECTION)
+    sampleWait(SAMPLE_INTERVAL_MS);
+    return;
   }
-  delay(500);
+#ifdef PIPELINED_TASKS
+  // Drawn by renderTask() while the next integration is already running
+  renderPost(&result);
+#else
+  drawColorClass(col);
+#endif
+#ifdef STABLE_DETECTION
+  sampleWait(SAMPLE_INTERVAL_MS);
+#else
+  sampleWait(500);
+#endif
 }
 
-// Write on mini display of esp32 the rgb data
-void drawRGBText(unsigned char r, unsigned char g, unsigned char b)
+// Icon and name of a class on the display
+void drawColorClass(ColorClass col)
 {
-  u8g2.clearBuffer();
-  // Testo centrato sotto la bitmap
-  u8g2.setFont(u8g2_font_ncenB08_tr);
-  int x_text = X_OFFSET;
-  int y_text = Y_OFFSET + OLED_HEIGHT - (9*3);
-  char buffer[50];
-  sprintf(buffer,"r: %d",r);
-  u8g2.drawStr(x_text, y_text, buffer);
-
-  y_text = Y_OFFSET + OLED_HEIGHT - (9*2);
-  memset(buffer,0,50);
-  sprintf(buffer,"g: %d",g);
-  u8g2.drawStr(x_text, y_text, buffer);
-
-  y_text = Y_OFFSET + OLED_HEIGHT - (9);
-  memset(buffer,0,50);
-  sprintf(buffer,"b: %d",b);
-  u8g2.drawStr(x_text, y_text, buffer);
-
-  u8g2.sendBuffer();
+  ClassDescriptor descriptor;
+  classDescriptorRead(class_descriptors, col, &descriptor);
+  char name[CLASS_NAME_SIZE];
+  classNameCopy(&descriptor, name, sizeof(name));
+  int16_t textWidth = descriptor.textWidth;
+#ifdef DISPLAY_PROPORTIONAL_FONT
+  // Measured on the first draw of each class only
+  static int16_t measured[COLOR_CLASS_COUNT + 1];
+  uint8_t index = classDescriptorIndex(col);
+  if (measured[index] == 0) {
+    measured[index] = DisplayDriver::textWidth(name);
+  }
+  textWidth = measured[index];
+#endif
+  uint8_t size = descriptor.bitmap ? BITMAP_SIZE : 0;
+  drawBitmapWithText(descriptor.bitmap, size, size, name, textWidth);
 }
 
-// Bitmap and text draw function (2/3 Bitmap, 1/3 String) 
-void drawBitmapWithText(const unsigned char* bitmap, int bmp_width, int bmp_height, const char* message) 
+// Hand a result to renderTask(), never waits for the display
+void renderPost(const PipelineResult* result)
 {
-  #ifdef ENABLE_DISPLAY
-    #ifdef COLORBLINDHELPER_OLED042
-      // --- PER OLED 0.42" su ESP32-C3/U8G2 ---
-      u8g2.clearBuffer();
-
-      // Bitmap centrata nell'area visibile con offset
-      int x_bmp = X_OFFSET + (OLED_WIDTH  - bmp_width) / 2;
-      int y_bmp = Y_OFFSET;
-      u8g2.drawXBMP(x_bmp, y_bmp, bmp_width, bmp_height, bitmap);
+#ifdef PIPELINED_TASKS
+  RenderJob job;
+  job.seq = render_mailbox.posted;
+  job.color = result->color;
+  job.colorClass = result->colorClass;
+  job.distance = result->distance;
+  job.postedUs = micros();
+  renderMailboxPost(&render_mailbox, &job);
+  xTaskNotifyGive(render_task);
+#else
+  (void)result;
+#endif
+}
 
-      // Testo centrato sotto la bitmap
-      u8g2.setFont(u8g2_font_ncenB08_tr);
-      int textWidth = u8g2.getStrWidth(message);
-      int x_text = X_OFFSET + (OLED_WIDTH - textWidth) / 2;
-      int y_text = Y_OFFSET + OLED_HEIGHT - 8 -1;
+// Display task: sleeps until loop() posts a result, then draws the newest
+// one; results posted while a frame was being sent are skipped
+void renderTask(void* arg)
+{
+  (void)arg;
+#ifdef PIPELINED_TASKS
+  RenderJob job;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (renderMailboxTake(&render_mailbox, &job)) {
+      drawColorClass(job.colorClass);
+    }
+  }
+#endif
+}
 
-      u8g2.drawStr(x_text, y_text, message);
+void busLock()
+{
+#ifdef PIPELINED_TASKS
+  if (i2c_bus) {
+    xSemaphoreTake(i2c_bus, portMAX_DELAY);
+  }
+#endif
+}
 
-      u8g2.sendBuffer();
+void busUnlock()
+{
+#ifdef PIPELINED_TASKS
+  if (i2c_bus) {
+    xSemaphoreGive(i2c_bus);
+  }
+#endif
+}
 
-  #else
-      // --- PER DISPLAY CLASSICO Adafruit SSD1306 ---
-      display.clearDisplay();
-      int x_bmp = (display.width() - bmp_width) / 2;
-      int y_bmp = 0;
-      display.drawBitmap(x_bmp, y_bmp, bitmap, bmp_width, bmp_height, WHITE);
-
-      display.setTextSize(2); // o regola secondo font desiderato
-      display.setTextColor(WHITE);
-      int16_t x1, y1;
-      uint16_t w, h;
-      display.getTextBounds(message, 0, 0, &x1, &y1, &w, &h);
-      int x_text = (display.width() - w) / 2;
-      int y_text = bmp_height + ((display.height() - bmp_height - 16) / 2);
+// Raw values on the display (TEST_SENSOR)
+void drawRGBText(unsigned char r, unsigned char g, unsigned char b)
+{
+#ifdef ENABLE_DISPLAY
+  RGBColor color = {r, g, b};
+  DisplayDriver::drawRGB(color);
+  renderCacheInvalidate(&render_cache);
+#else
+  (void)r;
+  (void)g;
+  (void)b;
+#endif
+}
 
-      display.setCursor(x_text, y_text);
-      display.print(message);
-      display.display();
+// Bitmap and text draw function (2/3 Bitmap, 1/3 String) 
+void drawBitmapWithText(const unsigned char* bitmap, int bmp_width, int bmp_height, const char* message, int16_t textWidth) 
+{
+  #ifdef ENABLE_DISPLAY
+    // Already on screen: no redraw, no I2C
+    RenderAction action = renderCacheCheck(&render_cache, bitmap, message);
+    if (action == RENDER_SKIP) {
+      renderCacheAccount(&render_cache, 0, DISPLAY_FRAME_BYTES);
+    #ifdef SERIAL_TEXT_LOG
+      Serial.println(message);
+      loopLap(LOOP_SERIAL);
+    #endif
+      return;
+    }
+    uint16_t sent = DisplayDriver::draw(bitmap, bmp_width, bmp_height, message, textWidth, action);
+    renderCacheAccount(&render_cache, sent, DISPLAY_FRAME_BYTES);
+  #ifdef RENDER_STATS
+    Serial.print(F("I2C bytes sent: "));
+    Serial.print(render_cache.bytesSent);
+    Serial.print(F("  saved: "));
+    Serial.println(render_cache.bytesSaved);
   #endif
 #endif
+#ifdef SERIAL_TEXT_LOG
   Serial.println(message);
+#endif
+  loopLap(LOOP_SERIAL);
+  bootStage(BOOT_FIRST_RESULT);
 }
 
-#define THRESHOLD 700 
-// We calculate color as the minimum distance in 3 dimensions
-// (ignoring the square root which does not change for the purposes of finding the closest)
-ColorClass bestMatchRGB(RGBColor currentColor) 
-{
-  uint32_t minDist = 0xFFFFFFFF;
-  ColorClass best = COL_UNDEFINED;
-  for (unsigned int i = 0; i < sizeof(color_reference)/sizeof(color_reference[0]); i++) {
-    int dr = (int)currentColor.r - color_reference[i].reference_color.r;
-    int dg = (int)currentColor.g - color_reference[i].reference_color.g;
-    int db = (int)currentColor.b - color_reference[i].reference_color.b;
-    uint32_t dist = dr*dr + dg*dg + db*db;
-    if (dist < minDist && dist <= THRESHOLD) {
-      minDist = dist;
-      best = color_reference[i].color_class;
+// Compressed icon drawn span by span into the display buffer
+void drawRleBitmap(int x, int y, const unsigned char* asset)
+{
+#if defined(ENABLE_DISPLAY) && !defined(COLORBLINDHELPER_PAGED_OLED)
+  if (!asset) {
+    return;
+  }
+  RleDecoder rle;
+  rleBegin(&rle, asset);
+  uint8_t value;
+  uint8_t length;
+  while ((length = rlePeek(&rle, &value)) != 0) {
+    if (value) {
+    #ifdef COLORBLINDHELPER_OLED042
+      u8g2.drawHLine(x + rle.x, y + rle.y, length);
+    #else
+      display.drawFastHLine(x + rle.x, y + rle.y, length, WHITE);
+    #endif
     }
+    rleConsume(&rle, length);
   }
-  Serial.println(minDist);
-  return best;
+#else
+  (void)x;
+  (void)y;
+  (void)asset;
+#endif
+}
+
+// Send only the pages first..last of the SSD1306 framebuffer, display() always sends all of them
+void ssd1306FlushPages(uint8_t first, uint8_t last)
+{
+#if defined(ENABLE_DISPLAY) && !defined(COLORBLINDHELPER_OLED042) && !defined(COLORBLINDHELPER_PAGED_OLED)
+  display.ssd1306_command(SSD1306_PAGEADDR);
+  display.ssd1306_command(first);
+  display.ssd1306_command(last);
+  display.ssd1306_command(SSD1306_COLUMNADDR);
+  display.ssd1306_command(0);
+  display.ssd1306_command(SCREEN_WIDTH - 1);
+
+  const uint8_t* data = display.getBuffer() + first * SCREEN_WIDTH;
+  uint16_t count = (last - first + 1) * SCREEN_WIDTH;
+  Wire.setClock(400000);  // same bus speed display() uses
+  while (count) {
+    // The Wire buffer is 32 bytes on AVR, control byte included
+    uint8_t chunk = count > 31 ? 31 : count;
+    Wire.beginTransmission(OLED_ADDR);
+    Wire.write((uint8_t)0x40);  // data stream
+    Wire.write(data, chunk);
+    Wire.endTransmission();
+    data += chunk;
+    count -= chunk;
+  }
+  Wire.setClock(100000);
+#else
+  (void)first;
+  (void)last;
+#endif
 }
 
 // Function for RAW sensor reading to obtain calibration data
@@ -405,20 +933,38 @@ RGBColor rgbSensorReadTCS3200()
   digitalWrite(S2, LOW);
   digitalWrite(S3, HIGH);
   int blueRaw = pulseIn(OUT, LOW);
+  telemetryRaw(redRaw, greenRaw, blueRaw, 0);
 
   // Converting from raw to 0-255 scale (mapping the range between your minimums and maximums)
-  int red = map(redRaw, redMin, redMax, 255, 0);
-  int green = map(greenRaw, greenMin, greenMax, 255, 0);
-  int blue = map(blueRaw, blueMin, blueMax, 255, 0);
-
-  // Limit values ​​between 0 and 255
-  colorData.r = constrain(red, 0, 255);
-  colorData.g = constrain(green, 0, 255);
-  colorData.b = constrain(blue, 0, 255);
+  colorData.r = tcs3200RawToChannel(redRaw, device_config.tcs3200Min[0], device_config.tcs3200Max[0]);
+  colorData.g = tcs3200RawToChannel(greenRaw, device_config.tcs3200Min[1], device_config.tcs3200Max[1]);
+  colorData.b = tcs3200RawToChannel(blueRaw, device_config.tcs3200Min[2], device_config.tcs3200Max[2]);
 
   return colorData;
 }
 
+// Same conversion fed by the Timer1 capture driver, false until a new R/G/B triple is ready
+bool rgbSensorReadTCS3200Capture(RGBColor* color)
+{
+#ifdef TCS3200_CAPTURE
+  TCS3200Capture capture;
+  if (!tcs3200CaptureRead(&capture)) {
+    return false;
+  }
+  uint16_t redUs = tcs3200CapturePulseUs(&capture, 0);
+  uint16_t greenUs = tcs3200CapturePulseUs(&capture, 1);
+  uint16_t blueUs = tcs3200CapturePulseUs(&capture, 2);
+  telemetryRaw(redUs, greenUs, blueUs, 0);
+  color->r = tcs3200RawToChannel(redUs, device_config.tcs3200Min[0], device_config.tcs3200Max[0]);
+  color->g = tcs3200RawToChannel(greenUs, device_config.tcs3200Min[1], device_config.tcs3200Max[1]);
+  color->b = tcs3200RawToChannel(blueUs, device_config.tcs3200Min[2], device_config.tcs3200Max[2]);
+  return true;
+#else
+  (void)color;
+  return false;
+#endif
+}
+
 // Function for reading color in RGB format with calibration data
 void rawSesnsorRead() 
 {
@@ -440,16 +986,16 @@ void rawSesnsorRead()
    
   
 #ifdef ENABLE_DISPLAY
-  char buffer[200];
-  sprintf(buffer,"r: %d, g: %d, b: %d",red,green,blue);
-  drawBitmapWithText(nullptr,0,0,buffer);
+  char buffer[32];  // "r: 65535, g: 65535, b: 65535", longer pulses are cut
+  snprintf_P(buffer, sizeof(buffer), PSTR("r: %d, g: %d, b: %d"), red, green, blue);
+  drawBitmapWithText(nullptr, 0, 0, buffer, TEXT_WIDTH_MEASURE);
 #endif
   
-  Serial.print("Red: ");
+  Serial.print(F("Red: "));
   Serial.print(red);
-  Serial.print("  Green: ");
+  Serial.print(F("  Green: "));
   Serial.print(green);
-  Serial.print("  Blue: ");
+  Serial.print(F("  Blue: "));
   Serial.println(blue);
 
   delay(500);
@@ -464,22 +1010,407 @@ RGBColor readRGBColorTCS34725()
   color.b = 255;
   return color;
 #else
-  float r,g,b;
-  tcs.getRGB(&r,&g,&b);
-
-  color.r = (uint8_t)r;
-  color.g = (uint8_t)g;
-  color.b = (uint8_t)b;
-
-  Serial.print("Red: ");
-  Serial.print(r);
-  Serial.print("  Green: ");
-  Serial.print(g);
-  Serial.print("  Blue: ");
-  Serial.println(b);
-  // Serial.print("  Clear: ");
+  uint16_t r, g, b, c;
+  tcs.getRawData(&r, &g, &b, &c);
+  telemetryRaw(r, g, b, c);
+  color = tcs34725RawToRGB(r, g, b, c);
+  loopLap(LOOP_SENSOR);
+
+#ifdef SERIAL_TEXT_LOG
+  Serial.print(F("Red: "));
+  Serial.print(color.r);
+  Serial.print(F("  Green: "));
+  Serial.print(color.g);
+  Serial.print(F("  Blue: "));
+  Serial.println(color.b);
+  // Serial.print(F("  Clear: "));
   // Serial.println(cRaw);
+  loopLap(LOOP_SERIAL);
+#endif
 
   return color;
 #endif
-}
\ No newline at end of file
+}
+
+// Non-blocking version, false while the sensor is still integrating
+bool readRGBColorTCS34725Async(RGBColor* color)
+{
+#if defined(TCS34725_ASYNC) && defined(ENABLE_SENSOR)
+  TCS34725Raw raw;
+  busLock();
+  bool ready = tcs34725AsyncPoll(tcs, &raw);
+  busUnlock();
+  loopLap(LOOP_SENSOR);
+  if (!ready) {
+    return false;
+  }
+  telemetryRaw(raw.r, raw.g, raw.b, raw.c);
+  *color = tcs34725RawToRGB(raw.r, raw.g, raw.b, raw.c);
+
+#ifdef SERIAL_TEXT_LOG
+  Serial.print(F("Red: "));
+  Serial.print(color->r);
+  Serial.print(F("  Green: "));
+  Serial.print(color->g);
+  Serial.print(F("  Blue: "));
+  Serial.print(color->b);
+  Serial.print(F("  Step: "));
+  Serial.println(tcs34725AsyncStep());
+  loopLap(LOOP_SERIAL);
+#endif
+  return true;
+#else
+  (void)color;
+  return false;
+#endif
+}
+
+// Raw channels of the last reading, sent with the next telemetry frame
+void telemetryRaw(uint16_t r, uint16_t g, uint16_t b, uint16_t c)
+{
+#ifdef TELEMETRY
+  telemetry_sample.raw[0] = r;
+  telemetry_sample.raw[1] = g;
+  telemetry_sample.raw[2] = b;
+  telemetry_sample.clear = c;
+#else
+  (void)r;
+  (void)g;
+  (void)b;
+  (void)c;
+#endif
+}
+
+// One frame per classified sample. Never waits: with the TX buffer full
+// the frame is dropped and the gap in the sequence numbers shows it
+void telemetrySend(RGBColor color, ColorClass col, uint32_t distance)
+{
+#ifdef TELEMETRY
+  telemetry_sample.color = color;
+  telemetry_sample.colorClass = col;
+  telemetry_sample.distance = distance;
+  uint8_t frame[TELEMETRY_FRAME_SIZE];
+  telemetryEncode(&telemetry_sample, frame);
+  if (Serial.availableForWrite() >= TELEMETRY_FRAME_SIZE) {
+    Serial.write(frame, TELEMETRY_FRAME_SIZE);
+  }
+  telemetry_sample.seq++;
+#else
+  (void)color;
+  (void)col;
+  (void)distance;
+#endif
+}
+
+// Reference table of the record in place of the built-in one, if it has one
+void configApply()
+{
+  if (device_config.referenceCount == 0) {
+    colorMatchSetTable(nullptr, 0, nullptr);
+  } else if (!colorMatchSetTable(device_config.references, device_config.referenceCount, device_config.thresholds)) {
+  #ifdef SERIAL_TEXT_LOG
+    Serial.println(F("Stored table not usable with this matcher"));
+  #endif
+  }
+}
+
+// One command from the serial port, see CONFIG_CMD_*. Blocks only while
+// measuring or receiving a record, never in normal use
+void configCommand()
+{
+  char command = Serial.read();
+  bool ok = true;
+  if (command == CONFIG_CMD_WHITE) {
+  #if defined(ENABLE_SENSOR) && defined(TCS3200)
+    tcs3200MeasurePulses(device_config.tcs3200Min);
+  #elif defined(ENABLE_SENSOR) && defined(TCS34725) && !defined(TCS34725_ASYNC)
+    // Clear channel of the white surface at every gain, 1x to 60x
+    uint16_t clearAtGain[4];
+    for (uint8_t gain = 0; gain < 4; gain++) {
+      uint16_t r, g, b;
+      tcs.setGain((tcs34725Gain_t)gain);
+      tcs.getRawData(&r, &g, &b, &clearAtGain[gain]);
+    }
+    // Full scale of the Adafruit default integration time (2.4 ms)
+    device_config.tcs34725Gain = deviceConfigPickGain(clearAtGain, tcs34725RangingMaxCount(0));
+    tcs.setGain((tcs34725Gain_t)device_config.tcs34725Gain);
+  #else
+    ok = false;   // the asynchronous reading picks the gain by itself
+  #endif
+  } else if (command == CONFIG_CMD_BLACK) {
+  #if defined(ENABLE_SENSOR) && defined(TCS3200)
+    tcs3200MeasurePulses(device_config.tcs3200Max);
+  #else
+    ok = false;
+  #endif
+  } else if (command == CONFIG_CMD_UPLOAD) {
+    uint8_t record[DEVICE_CONFIG_RECORD_SIZE];
+    ok = Serial.readBytes(record, DEVICE_CONFIG_RECORD_SIZE) == DEVICE_CONFIG_RECORD_SIZE
+      && deviceConfigDecode(record, &device_config);
+  } else if (command == CONFIG_CMD_RESET) {
+    deviceConfigDefaults(&device_config);
+  } else if (command == CONFIG_CMD_MEMORY) {
+    memReport();
+    return;
+  } else if (command == CONFIG_CMD_PROFILE) {
+    loopReport();
+    return;
+  } else {
+    return;
+  }
+  if (ok) {
+    ok = deviceConfigSave(&device_config);
+    configApply();
+  }
+  if (ok) {
+    Serial.println(F("OK"));
+  } else {
+    Serial.println(F("ERR"));
+  }
+}
+
+// Free RAM and stack high-water mark, as text or as a telemetry memory frame
+void memReport()
+{
+#ifdef MEM_STATS
+  MemStats stats;
+  memStatsRead(&stats);
+  #ifdef TELEMETRY
+    uint8_t frame[TELEMETRY_MEM_FRAME_SIZE];
+    telemetryEncodeMem(&stats, frame);
+    Serial.write(frame, TELEMETRY_MEM_FRAME_SIZE);
+  #else
+    Serial.print(F("Mem free "));
+    Serial.print(stats.freeRam);
+    Serial.print(F(" stack_free "));
+    Serial.print(stats.stackFree);
+    Serial.print(F(" stack_peak "));
+    Serial.print(stats.stackPeak);
+    Serial.print(F(" heap "));
+    Serial.println(stats.heapBreak);
+  #endif
+#else
+  Serial.println(F("ERR"));
+#endif
+}
+
+// Average LOW pulse width of each filter, same unit as the normal reading
+void tcs3200MeasurePulses(int16_t pulses[3])
+{
+  uint32_t sum[3] = {0, 0, 0};
+#ifdef TCS3200_CAPTURE
+  TCS3200Capture capture;
+  for (uint8_t n = 0; n < CONFIG_CALIBRATION_READS; ) {
+    if (tcs3200CaptureRead(&capture)) {
+      for (uint8_t i = 0; i < 3; i++) {
+        sum[i] += tcs3200CapturePulseUs(&capture, i);
+      }
+      n++;
+    }
+  }
+#else
+  static const uint8_t filterS2[3] = {LOW, HIGH, LOW};
+  static const uint8_t filterS3[3] = {LOW, HIGH, HIGH};
+  for (uint8_t n = 0; n < CONFIG_CALIBRATION_READS; n++) {
+    for (uint8_t i = 0; i < 3; i++) {
+      digitalWrite(S2, filterS2[i]);
+      digitalWrite(S3, filterS3[i]);
+      sum[i] += pulseIn(OUT, LOW);
+    }
+  }
+#endif
+  for (uint8_t i = 0; i < 3; i++) {
+    pulses[i] = (int16_t)(sum[i] / CONFIG_CALIBRATION_READS);
+  }
+}
+
+// Stamp an init stage; after the first result the whole profile is sent once
+void bootStage(BootStage stage)
+{
+#ifdef BOOT_PROFILE
+  if (!bootProfileMark(&boot_profile, stage, micros())) {
+    return;
+  }
+  #ifdef TELEMETRY
+    uint8_t frame[TELEMETRY_BOOT_FRAME_SIZE];
+    telemetryEncodeBoot(&boot_profile, frame);
+    Serial.write(frame, TELEMETRY_BOOT_FRAME_SIZE);
+  #elif defined(SERIAL_TEXT_LOG)
+    Serial.print(F("Boot us:"));
+    for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+      Serial.print(' ');
+      Serial.print((const __FlashStringHelper*)bootStageName((BootStage)i));
+      Serial.print(' ');
+      Serial.print(boot_profile.us[i]);
+    }
+    Serial.println();
+  #endif
+#else
+  (void)stage;
+#endif
+}
+
+// SWEEP_MODE: every reading into the run-length sequence, no pause and no
+// redraw while sweeping. Once the sensor is lifted the sequence is drawn,
+// the segments and their times go to the serial port, and a new sweep starts
+void sweepStep(ColorClass col)
+{
+#ifdef SWEEP_MODE
+  uint32_t now = millis();
+  uint32_t elapsed = now - sweep_last_ms;
+  sweep_last_ms = now;
+  colorSweepAdd(&color_sweep, col, elapsed > 0xFFFF ? 0xFFFF : (uint16_t)elapsed);
+  if (!colorSweepEnded(&color_sweep, SWEEP_END_MS)) {
+    return;
+  }
+  char text[SWEEP_TEXT_SIZE];
+  if (colorSweepFormat(&color_sweep, class_descriptors, text, sizeof(text)) > 0) {
+    drawBitmapWithText(nullptr, 0, 0, text, TEXT_WIDTH_MEASURE);
+    sweepReport();
+  }
+  colorSweepReset(&color_sweep);
+#else
+  (void)col;
+#endif
+}
+
+// "Sweep: ROSSO 120 > BLU 85 > VERDE 140" in ms, undefined gaps as "?"
+void sweepReport()
+{
+#if defined(SWEEP_MODE) && !defined(TELEMETRY)
+  Serial.print(F("Sweep:"));
+  for (uint8_t i = 0; i < color_sweep.count; i++) {
+    const SweepSegment* segment = &color_sweep.segments[i];
+    if (i) {
+      Serial.print(F(" >"));
+    }
+    Serial.print(' ');
+    if (segment->colorClass == COL_UNDEFINED) {
+      Serial.print('?');
+    } else {
+      ClassDescriptor descriptor;
+      classDescriptorRead(class_descriptors, (ColorClass)segment->colorClass, &descriptor);
+      char name[CLASS_NAME_SIZE];
+      classNameCopy(&descriptor, name, sizeof(name));
+      Serial.print(name);
+    }
+    Serial.print(' ');
+    Serial.print(segment->ms);
+  }
+  if (color_sweep.truncated) {
+    Serial.print(F(" .."));
+  }
+  Serial.println();
+#endif
+}
+
+// Time since the previous lap into the histogram of a loop() stage
+void loopLap(LoopStage stage)
+{
+#ifdef LOOP_PROFILE
+  #ifdef PIPELINED_TASKS
+    // renderTask() draws on its own, only loop() is profiled
+    if (xTaskGetCurrentTaskHandle() == render_task) {
+      return;
+    }
+  #endif
+  loopProfileLap(&loop_profile, stage, loopProfileNow());
+#else
+  (void)stage;
+#endif
+}
+
+// One line per stage: count, upper bounds of the median and 99th
+// percentile (top of their bin) and longest in us, then bin:count of the
+// non empty bins (bin b: 2^(b-1) to 2^b ticks). Starts over afterwards
+void loopReport()
+{
+#ifdef LOOP_PROFILE
+  uint16_t perUs = loop_profile.ticksPerUs;
+  Serial.print(F("Loop ticks/us "));
+  Serial.println(perUs);
+  for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+    LoopStage stage = (LoopStage)i;
+    Serial.print((const __FlashStringHelper*)loopStageName(stage));
+    Serial.print(F(" n "));
+    Serial.print(loopProfileCount(&loop_profile, stage));
+    Serial.print(F(" p50<= "));
+    Serial.print(loopProfilePercentile(&loop_profile, stage, 50) / perUs);
+    Serial.print(F(" p99<= "));
+    Serial.print(loopProfilePercentile(&loop_profile, stage, 99) / perUs);
+    Serial.print(F(" max "));
+    Serial.print(loop_profile.maxTicks[stage] / perUs);
+    Serial.print(F(" |"));
+    for (uint8_t b = 0; b < LOOP_PROFILE_BINS; b++) {
+      if (loop_profile.bins[stage][b]) {
+        Serial.print(' ');
+        Serial.print(b);
+        Serial.print(':');
+        Serial.print(loop_profile.bins[stage][b]);
+      }
+    }
+    Serial.println();
+  }
+  loopProfileReset(&loop_profile, perUs, loopProfileNow());
+#else
+  Serial.println(F("ERR"));
+#endif
+}
+
+// Pause between two samples. With LOW_POWER the CPU sleeps instead of
+// spinning in delay(), and on long pauses the sensor and its LED are off
+void sampleWait(uint16_t ms)
+{
+#ifdef LOW_POWER
+  bool sensorOff = ms >= SENSOR_OFF_MIN_MS;
+  if (sensorOff) {
+    sensorSleep();
+  }
+  Serial.flush();   // power-down would cut the bytes still in the UART
+  lowPowerSleepMs(ms, -1);
+  if (sensorOff) {
+    sensorWake();
+  }
+#else
+  delay(ms);
+#endif
+  loopLap(LOOP_WAIT);
+}
+
+// Asynchronous reading not ready: sleep until the integration can be over
+// (or the sensor INT pin fires) instead of polling I2C
+void integrationWait()
+{
+#if defined(LOW_POWER) && defined(TCS34725_ASYNC) && defined(ENABLE_SENSOR)
+  uint16_t remaining = tcs34725AsyncRemainingMs();
+  if (remaining > 0) {
+    Serial.flush();
+    // millis() stops in power-down on the Nano: without this the remaining
+    // time would never go down
+    tcs34725AsyncAddSleptMs(lowPowerSleepMs(remaining, INTEGRATION_WAKE_PIN));
+  } else {
+    lowPowerIdle();
+  }
+#elif defined(PIPELINED_TASKS) && defined(TCS34725_ASYNC) && defined(ENABLE_SENSOR)
+  // Leave the CPU to renderTask() instead of polling the bus it is using
+  uint16_t remaining = tcs34725AsyncRemainingMs();
+  delay(remaining > 0 ? remaining : 1);
+#endif
+  loopLap(LOOP_WAIT);
+}
+
+void sensorSleep()
+{
+#ifdef SENSOR_LED_PIN
+  digitalWrite(SENSOR_LED_PIN, LOW);
+#endif
+  SensorDriver::sleep();
+}
+
+void sensorWake()
+{
+#ifdef SENSOR_LED_PIN
+  digitalWrite(SENSOR_LED_PIN, HIGH);
+#endif
+  SensorDriver::wake();
+}
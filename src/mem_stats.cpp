@@ -0,0 +1,97 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "mem_stats.h"
+
+void memPaint(uint8_t* low, uint8_t* high)
+{
+  while (low < high) {
+    *low++ = MEM_PAINT;
+  }
+}
+
+uint32_t memPaintedBytes(const uint8_t* low, const uint8_t* high)
+{
+  const uint8_t* p = low;
+  while (p < high && *p == MEM_PAINT) {
+    p++;
+  }
+  return (uint32_t)(p - low);
+}
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+
+#if defined(__AVR__)
+
+extern uint8_t _end;        // end of .bss, where the heap starts
+extern uint8_t __stack;     // RAMEND, top of the stack
+extern char* __brkval;      // top of the heap, 0 until the first malloc()
+
+// Bytes left unpainted under the stack pointer: the frame of memPaint()
+#define MEM_PAINT_GUARD 16
+
+void memStatsBegin()
+{
+  uint8_t* heapTop = __brkval ? (uint8_t*)__brkval : &_end;
+  memPaint(heapTop, (uint8_t*)SP - MEM_PAINT_GUARD);
+}
+
+void memStatsRead(MemStats* stats)
+{
+  uint8_t* heapTop = __brkval ? (uint8_t*)__brkval : &_end;
+  uint8_t* sp = (uint8_t*)SP;
+  uint32_t untouched = memPaintedBytes(heapTop, sp);
+  stats->freeRam = sp - heapTop;
+  stats->stackFree = untouched;
+  stats->stackPeak = &__stack - (heapTop + untouched) + 1;
+  stats->heapBreak = (uint16_t)heapTop;
+}
+
+#elif defined(ESP32)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#ifndef ARDUINO_LOOP_STACK_SIZE
+  #define ARDUINO_LOOP_STACK_SIZE 8192
+#endif
+
+void memStatsBegin()
+{
+  // FreeRTOS fills every task stack when it creates it
+}
+
+void memStatsRead(MemStats* stats)
+{
+  // Called from loop(): the high-water mark of its own task, in bytes on ESP-IDF
+  uint32_t unused = uxTaskGetStackHighWaterMark(nullptr);
+  stats->freeRam = ESP.getFreeHeap();
+  stats->stackFree = unused;
+  stats->stackPeak = ARDUINO_LOOP_STACK_SIZE - unused;
+  stats->heapBreak = ESP.getMinFreeHeap();
+}
+
+#else
+
+void memStatsBegin()
+{
+}
+
+void memStatsRead(MemStats* stats)
+{
+  stats->freeRam = 0;
+  stats->stackFree = 0;
+  stats->stackPeak = 0;
+  stats->heapBreak = 0;
+}
+
+#endif
+
+#endif
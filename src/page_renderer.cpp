@@ -0,0 +1,189 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include <string.h>
+
+#include "page_renderer.h"
+#include "pgm_compat.h"
+
+// Set the pixels of columns [x, x+w) and rows [y, y+h) that fall inside the page
+static void fillBlock(uint8_t* out, int16_t pageTop, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t top = y > pageTop ? y : pageTop;
+  int16_t bottom = y + h < pageTop + 8 ? y + h : pageTop + 8;
+  if (top >= bottom) {
+    return;
+  }
+  uint8_t mask = (uint8_t)(((1 << (bottom - top)) - 1) << (top - pageTop));
+  int16_t left = x > 0 ? x : 0;
+  int16_t right = x + w < PAGE_SCREEN_WIDTH ? x + w : PAGE_SCREEN_WIDTH;
+  for (int16_t col = left; col < right; col++) {
+    out[col] |= mask;
+  }
+}
+
+static void renderBitmap(const PageFrame* frame, int16_t pageTop, uint8_t* out)
+{
+  int16_t top = frame->bmpY > pageTop ? frame->bmpY : pageTop;
+  int16_t bottom = frame->bmpY + frame->bmpH < pageTop + 8 ? frame->bmpY + frame->bmpH : pageTop + 8;
+  uint8_t byteWidth = (frame->bmpW + 7) / 8;
+  for (int16_t y = top; y < bottom; y++) {
+    const unsigned char* row = frame->bitmap + (y - frame->bmpY) * byteWidth;
+    uint8_t bit = (uint8_t)(1 << (y - pageTop));
+    uint8_t bits = 0;
+    for (uint8_t i = 0; i < frame->bmpW; i++) {
+      if (i & 7) {
+        bits <<= 1;
+      } else {
+        bits = pgm_read_byte(row + i / 8);
+      }
+      int16_t x = frame->bmpX + i;
+      if ((bits & 0x80) && x >= 0 && x < PAGE_SCREEN_WIDTH) {
+        out[x] |= bit;
+      }
+    }
+  }
+}
+
+// Compressed icon: spans decoded straight into the page. Pages drawn top to
+// bottom continue from the decoder position, going back restarts the icon
+static void renderBitmapRle(const PageFrame* frame, int16_t pageTop, uint8_t* out)
+{
+  RleDecoder* dec = frame->rle;
+  int16_t first = (frame->bmpY > pageTop ? frame->bmpY : pageTop) - frame->bmpY;
+  int16_t last = (frame->bmpY + frame->bmpH < pageTop + 8 ? frame->bmpY + frame->bmpH : pageTop + 8) - frame->bmpY;
+  if (dec->data != frame->bitmap || dec->y > first) {
+    rleBegin(dec, frame->bitmap);
+  }
+  rleSkipTo(dec, (uint8_t)first);
+  uint8_t value;
+  uint8_t length;
+  while (dec->y < last && (length = rlePeek(dec, &value)) != 0) {
+    if (value) {
+      uint8_t bit = (uint8_t)(1 << (frame->bmpY + dec->y - pageTop));
+      int16_t left = frame->bmpX + dec->x;
+      int16_t right = left + length;
+      left = left > 0 ? left : 0;
+      right = right < PAGE_SCREEN_WIDTH ? right : PAGE_SCREEN_WIDTH;
+      for (int16_t x = left; x < right; x++) {
+        out[x] |= bit;
+      }
+    }
+    rleConsume(dec, length);
+  }
+}
+
+static void renderChar(const PageFrame* frame, int16_t pageTop, uint8_t* out, int16_t x, int16_t y, unsigned char c)
+{
+  uint8_t size = frame->textSize;
+  if (x >= PAGE_SCREEN_WIDTH || x + 6 * size - 1 < 0 || y > pageTop + 7 || y + 8 * size - 1 < pageTop) {
+    return;
+  }
+  // Adafruit GFX skips the missing glyph 176 of the original font
+  if (c >= 176) {
+    c++;
+  }
+  for (uint8_t i = 0; i < 5; i++) {
+    uint8_t line = pgm_read_byte(frame->font + c * 5 + i);
+    for (uint8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        fillBlock(out, pageTop, x + i * size, y + j * size, size, size);
+      }
+    }
+  }
+}
+
+// Walks the message like Adafruit_GFX::write() with text wrap on
+static void renderText(const PageFrame* frame, int16_t pageTop, uint8_t* out)
+{
+  uint8_t size = frame->textSize;
+  int16_t x = frame->textX;
+  int16_t y = frame->textY;
+  for (const char* p = frame->message; *p; p++) {
+    if (*p == '\n') {
+      x = 0;
+      y += size * 8;
+    } else if (*p != '\r') {
+      if (x + size * 6 > PAGE_SCREEN_WIDTH) {
+        x = 0;
+        y += size * 8;
+      }
+      renderChar(frame, pageTop, out, x, y, (unsigned char)*p);
+      x += size * 6;
+    }
+  }
+}
+
+void pageTextBounds(const char* message, uint8_t textSize, uint16_t* w, uint16_t* h)
+{
+  int16_t x = 0, y = 0;
+  int16_t maxX = -1, maxY = -1;
+  for (const char* p = message; *p; p++) {
+    if (*p == '\n') {
+      x = 0;
+      y += textSize * 8;
+    } else if (*p != '\r') {
+      if (x + textSize * 6 > PAGE_SCREEN_WIDTH) {
+        x = 0;
+        y += textSize * 8;
+      }
+      if (x + textSize * 6 - 1 > maxX) {
+        maxX = x + textSize * 6 - 1;
+      }
+      if (y + textSize * 8 - 1 > maxY) {
+        maxY = y + textSize * 8 - 1;
+      }
+      x += textSize * 6;
+    }
+  }
+  *w = (uint16_t)(maxX + 1);
+  *h = (uint16_t)(maxY + 1);
+}
+
+void pageLayout(PageFrame* frame, const unsigned char* bitmap, uint8_t bmpW, uint8_t bmpH,
+                const char* message, const unsigned char* font, int16_t textWidth,
+                uint8_t* textFirst, uint8_t* textLast)
+{
+  frame->bitmap = bitmap;
+  frame->rle = nullptr;
+  frame->bmpX = (PAGE_SCREEN_WIDTH - bmpW) / 2;
+  frame->bmpY = 0;
+  frame->bmpW = bmpW;
+  frame->bmpH = bmpH;
+  frame->message = message;
+  frame->textSize = 2;
+  frame->font = font;
+  uint16_t w, h;
+  if (textWidth < 0) {
+    pageTextBounds(message, frame->textSize, &w, &h);
+  } else {
+    w = (uint16_t)textWidth;
+    h = frame->textSize * 8;
+  }
+  frame->textX = (PAGE_SCREEN_WIDTH - w) / 2;
+  frame->textY = bmpH + ((PAGE_SCREEN_HEIGHT - bmpH - 16) / 2);
+  int16_t bottom = frame->textY + h - 1;
+  *textFirst = frame->textY / 8;
+  *textLast = (bottom < PAGE_SCREEN_HEIGHT - 1 ? bottom : PAGE_SCREEN_HEIGHT - 1) / 8;
+}
+
+void pageRender(const PageFrame* frame, uint8_t page, uint8_t* out)
+{
+  int16_t pageTop = page * 8;
+  memset(out, 0, PAGE_SCREEN_WIDTH);
+  if (frame->bitmap && frame->bmpW && frame->bmpY < pageTop + 8 && frame->bmpY + frame->bmpH > pageTop) {
+    if (frame->rle) {
+      renderBitmapRle(frame, pageTop, out);
+    } else {
+      renderBitmap(frame, pageTop, out);
+    }
+  }
+  if (frame->message && frame->font) {
+    renderText(frame, pageTop, out);
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "palette.h"
+
+#ifdef PALETTE_COUNT_VISITS
+uint32_t palette_visits = 0;
+#endif
+
+typedef struct {
+  uint8_t query[3];
+  uint32_t dist;   // best distance so far, candidates must be strictly closer
+  int16_t index;
+} PaletteSearch;
+
+// Nearest neighbour in the implicit k-d tree [lo, hi). The near side is visited
+// first, the far side only if the splitting plane is closer than the best match.
+static void paletteSearch(const PaletteEntry* entries, uint16_t lo, uint16_t hi, uint8_t axis, PaletteSearch* search)
+{
+  while (lo < hi && search->dist > 0) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    const PaletteEntry* node = &entries[mid];
+    uint8_t point[3] = {pgm_read_byte(&node->r), pgm_read_byte(&node->g), pgm_read_byte(&node->b)};
+#ifdef PALETTE_COUNT_VISITS
+    palette_visits++;
+#endif
+
+    int16_t dr = (int16_t)search->query[0] - point[0];
+    int16_t dg = (int16_t)search->query[1] - point[1];
+    int16_t db = (int16_t)search->query[2] - point[2];
+    uint32_t dist = (uint32_t)((int32_t)dr*dr) + (uint32_t)((int32_t)dg*dg) + (uint32_t)((int32_t)db*db);
+    if (dist < search->dist) {
+      search->dist = dist;
+      search->index = mid;
+    }
+
+    int16_t diff = (int16_t)search->query[axis] - point[axis];
+    uint8_t next = axis == 2 ? 0 : axis + 1;
+    if (diff < 0) {
+      paletteSearch(entries, lo, mid, next, search);
+      lo = mid + 1;
+    } else {
+      paletteSearch(entries, mid + 1, hi, next, search);
+      hi = mid;
+    }
+    // Far side: skip it when nothing there can beat the current best
+    if ((uint32_t)((int32_t)diff*diff) >= search->dist) {
+      return;
+    }
+    axis = next;
+  }
+}
+
+int16_t paletteNearest(const Palette* palette, RGBColor currentColor, uint32_t threshold, uint32_t* minDist)
+{
+  PaletteSearch search;
+  search.query[0] = currentColor.r;
+  search.query[1] = currentColor.g;
+  search.query[2] = currentColor.b;
+  // Starting from the threshold prunes everything that could not match anyway
+  search.dist = threshold == 0xFFFFFFFF ? threshold : threshold + 1;
+  search.index = PALETTE_NO_MATCH;
+  paletteSearch(palette->entries, 0, palette->count, 0, &search);
+  if (minDist) {
+    *minDist = search.index == PALETTE_NO_MATCH ? 0xFFFFFFFF : search.dist;
+  }
+  return search.index;
+}
+
+void paletteName(const Palette* palette, int16_t index, char* buffer, size_t size)
+{
+  if (size == 0) {
+    return;
+  }
+  size_t i = 0;
+  if (index >= 0 && index < palette->count) {
+    const char* name = palette->names + pgm_read_word(&palette->entries[index].name);
+    for (; i + 1 < size; i++) {
+      char c = (char)pgm_read_byte(name + i);
+      if (c == '\0') {
+        break;
+      }
+      buffer[i] = c;
+    }
+  }
+  buffer[i] = '\0';
+}
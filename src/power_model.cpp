@@ -0,0 +1,62 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "power_model.h"
+
+void powerModelReset(PowerModel* model)
+{
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    model->us[i] = 0;
+  }
+}
+
+void powerModelAdd(PowerModel* model, PowerPhase phase, uint32_t us)
+{
+  model->us[phase] += us;
+}
+
+uint64_t powerModelTotalUs(const PowerModel* model)
+{
+  uint64_t total = 0;
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    total += model->us[i];
+  }
+  return total;
+}
+
+uint32_t powerModelAverageUa(const PowerModel* model, const PowerProfile* profile)
+{
+  uint64_t total = powerModelTotalUs(model);
+  if (total == 0) {
+    return 0;
+  }
+  // uA * us summed: 64 bit, a few hours at tens of mA overflow 32 bits
+  uint64_t charge = 0;
+  for (uint8_t i = 0; i < POWER_PHASE_COUNT; i++) {
+    charge += model->us[i] * profile->ua[i];
+  }
+  return (uint32_t)(charge / total);
+}
+
+uint16_t powerModelDutyPermille(const PowerModel* model, PowerPhase phase)
+{
+  uint64_t total = powerModelTotalUs(model);
+  if (total == 0) {
+    return 0;
+  }
+  return (uint16_t)(model->us[phase] * 1000 / total);
+}
+
+uint32_t powerModelBatteryHours(const PowerModel* model, const PowerProfile* profile, uint32_t capacityMah)
+{
+  uint32_t average = powerModelAverageUa(model, profile);
+  if (average == 0) {
+    return 0;
+  }
+  return (uint32_t)((uint64_t)capacityMah * 1000 / average);
+}
@@ -0,0 +1,81 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "render_cache.h"
+
+// FNV-1a, enough to tell two messages apart without keeping a copy in RAM
+static uint32_t messageHash(const char* message)
+{
+  uint32_t hash = 2166136261UL;
+  if (message) {
+    while (*message) {
+      hash ^= (uint8_t)*message++;
+      hash *= 16777619UL;
+    }
+  }
+  return hash;
+}
+
+void renderCacheReset(RenderCache* cache)
+{
+  cache->bitmap = nullptr;
+  cache->messageHash = 0;
+  cache->valid = false;
+  cache->textFirst = 1;
+  cache->textLast = 0;
+  cache->bytesSent = 0;
+  cache->bytesSaved = 0;
+  cache->frames = 0;
+  cache->skipped = 0;
+}
+
+RenderAction renderCacheCheck(RenderCache* cache, const unsigned char* bitmap, const char* message)
+{
+  uint32_t hash = messageHash(message);
+  RenderAction action = RENDER_FULL;
+  if (cache->valid && cache->bitmap == bitmap) {
+    action = cache->messageHash == hash ? RENDER_SKIP : RENDER_TEXT;
+  }
+  cache->bitmap = bitmap;
+  cache->messageHash = hash;
+  cache->valid = true;
+  cache->frames++;
+  if (action == RENDER_SKIP) {
+    cache->skipped++;
+  }
+  return action;
+}
+
+void renderCacheTextPages(RenderCache* cache, uint8_t* first, uint8_t* last)
+{
+  uint8_t newFirst = *first;
+  uint8_t newLast = *last;
+  if (cache->textFirst <= cache->textLast) {
+    if (cache->textFirst < *first) {
+      *first = cache->textFirst;
+    }
+    if (cache->textLast > *last) {
+      *last = cache->textLast;
+    }
+  }
+  cache->textFirst = newFirst;
+  cache->textLast = newLast;
+}
+
+void renderCacheAccount(RenderCache* cache, uint16_t sent, uint16_t fullBytes)
+{
+  cache->bytesSent += sent;
+  cache->bytesSaved += fullBytes - sent;
+}
+
+void renderCacheInvalidate(RenderCache* cache)
+{
+  cache->valid = false;
+  cache->textFirst = 1;
+  cache->textLast = 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifndef __AVR__
+
+#include "render_mailbox.h"
+
+void renderMailboxReset(RenderMailbox* mailbox)
+{
+  mailbox->back = 0;
+  mailbox->middle.store(1, std::memory_order_relaxed);
+  mailbox->front = 2;
+  mailbox->posted = 0;
+  mailbox->coalesced = 0;
+}
+
+void renderMailboxPost(RenderMailbox* mailbox, const RenderJob* job)
+{
+  mailbox->slots[mailbox->back] = *job;
+  // release: the slot contents are visible before the reader can swap it in
+  uint8_t previous = mailbox->middle.exchange(mailbox->back | RENDER_MAILBOX_FRESH, std::memory_order_acq_rel);
+  mailbox->back = previous & 0x03;
+  mailbox->posted++;
+  if (previous & RENDER_MAILBOX_FRESH) {
+    mailbox->coalesced++;
+  }
+}
+
+bool renderMailboxTake(RenderMailbox* mailbox, RenderJob* job)
+{
+  if (!(mailbox->middle.load(std::memory_order_relaxed) & RENDER_MAILBOX_FRESH)) {
+    return false;
+  }
+  // acquire: pairs with the release of the writer's exchange
+  uint8_t previous = mailbox->middle.exchange(mailbox->front, std::memory_order_acq_rel);
+  mailbox->front = previous & 0x03;
+  *job = mailbox->slots[mailbox->front];
+  return true;
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "rle_decoder.h"
+
+static uint8_t rleNibble(RleDecoder* dec)
+{
+  uint8_t b = pgm_read_byte(dec->data + 2 + (dec->nibble >> 1));
+  uint8_t n = (dec->nibble & 1) ? (b >> 4) : (b & 0x0F);
+  dec->nibble++;
+  return n;
+}
+
+// Next run length, 15 means "15 more and go on"
+static uint16_t rleRun(RleDecoder* dec)
+{
+  uint16_t run = 0;
+  uint8_t n;
+  do {
+    n = rleNibble(dec);
+    run += n;
+  } while (n == 15);
+  return run;
+}
+
+void rleBegin(RleDecoder* dec, const unsigned char* asset)
+{
+  dec->data = asset;
+  dec->nibble = 0;
+  dec->width = rleAssetWidth(asset);
+  dec->height = rleAssetHeight(asset);
+  dec->x = 0;
+  dec->y = 0;
+  dec->value = 0;
+  dec->run = rleRun(dec);
+}
+
+uint8_t rlePeek(RleDecoder* dec, uint8_t* value)
+{
+  if (dec->y >= dec->height) {
+    return 0;
+  }
+  // Empty run: the icon starts with an on pixel
+  while (dec->run == 0) {
+    dec->value ^= 1;
+    dec->run = rleRun(dec);
+  }
+  uint8_t left = dec->width - dec->x;
+  *value = dec->value;
+  return dec->run < left ? (uint8_t)dec->run : left;
+}
+
+void rleConsume(RleDecoder* dec, uint8_t length)
+{
+  dec->run -= length;
+  dec->x += length;
+  if (dec->x >= dec->width) {
+    dec->x = 0;
+    dec->y++;
+  }
+}
+
+void rleSkipTo(RleDecoder* dec, uint8_t y)
+{
+  uint8_t value;
+  uint8_t length;
+  while (dec->y < y && (length = rlePeek(dec, &value)) != 0) {
+    rleConsume(dec, length);
+  }
+}
@@ -0,0 +1,48 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "sample_pipeline.h"
+
+void samplePipelineReset(SamplePipeline* pipeline, PipelineMode mode)
+{
+  pipeline->mode = mode;
+  colorFilterReset(&pipeline->filter);
+  classHysteresisReset(&pipeline->hysteresis);
+  colorBurstReset(&pipeline->burst);
+}
+
+void samplePipelineRun(SamplePipeline* pipeline, RGBColor sample, PipelineResult* result)
+{
+  if (pipeline->mode == PIPELINE_BURST) {
+    MatchScore score;
+    result->ready = colorBurstAdd(&pipeline->burst, sample, &score);
+    if (result->ready) {
+      result->color = pipeline->burst.mean;
+      result->colorClass = score.best;
+      result->distance = score.bestDist;
+      result->show = true;
+      result->second = score.second;
+      result->confidence = score.confidence;
+      result->readings = pipeline->burst.used;
+    }
+    return;
+  }
+  if (pipeline->mode == PIPELINE_STABLE) {
+    // Classify the median of the last samples, not the single reading
+    colorFilterPush(&pipeline->filter, sample);
+    sample = colorFilterMedian(&pipeline->filter);
+  }
+  result->ready = true;
+  result->color = sample;
+  result->colorClass = bestMatchRGB(sample, &result->distance);
+  // Redraw only when a new class has been confirmed by consecutive samples
+  result->show = pipeline->mode == PIPELINE_SINGLE || classHysteresisUpdate(&pipeline->hysteresis, result->colorClass);
+  result->second = COL_UNDEFINED;
+  result->confidence = 0;
+  result->readings = 1;
+}
@@ -0,0 +1,102 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <string.h>
+
+#include "ssd1306_paged.h"
+
+// Same glyphs Adafruit_GFX::drawChar() uses
+#include <glcdfont.c>
+
+const unsigned char* const ssd1306_paged_font = font;
+
+static uint8_t paged_addr = 0x3C;
+
+// Init sequence of Adafruit_SSD1306::begin() for 128x64 with the internal charge pump
+static const uint8_t ssd1306_init[] PROGMEM = {
+  0xAE,         // display off
+  0xD5, 0x80,   // clock divide
+  0xA8, 0x3F,   // multiplex 64
+  0xD3, 0x00,   // display offset
+  0x40,         // start line 0
+  0x8D, 0x14,   // charge pump on
+  0x20, 0x00,   // horizontal addressing
+  0xA1,         // segment remap
+  0xC8,         // COM scan decreasing
+  0xDA, 0x12,   // COM pins
+  0x81, 0xCF,   // contrast
+  0xD9, 0xF1,   // precharge
+  0xDB, 0x40,   // VCOM detect
+  0xA4,         // resume from RAM
+  0xA6,         // normal (not inverted)
+  0x2E,         // scroll off
+  0xAF          // display on
+};
+
+static uint8_t pagedCommands(const uint8_t* commands, uint8_t count, bool progmem)
+{
+  Wire.beginTransmission(paged_addr);
+  Wire.write((uint8_t)0x00);  // command stream
+  for (uint8_t i = 0; i < count; i++) {
+    Wire.write(progmem ? pgm_read_byte(commands + i) : commands[i]);
+  }
+  return Wire.endTransmission();
+}
+
+static void pagedSend(const PageFrame* frame, uint8_t first, uint8_t last)
+{
+  const uint8_t window[] = {0x22, first, last, 0x21, 0, PAGE_SCREEN_WIDTH - 1};  // PAGEADDR, COLUMNADDR
+  pagedCommands(window, sizeof(window), false);
+
+  uint8_t page_buffer[PAGE_SCREEN_WIDTH];
+  for (uint8_t page = first; page <= last; page++) {
+    if (frame) {
+      pageRender(frame, page, page_buffer);
+    } else {
+      memset(page_buffer, 0, sizeof(page_buffer));
+    }
+    const uint8_t* data = page_buffer;
+    uint8_t count = PAGE_SCREEN_WIDTH;
+    while (count) {
+      // The Wire buffer is 32 bytes on AVR, control byte included
+      uint8_t chunk = count > 31 ? 31 : count;
+      Wire.beginTransmission(paged_addr);
+      Wire.write((uint8_t)0x40);  // data stream
+      Wire.write(data, chunk);
+      Wire.endTransmission();
+      data += chunk;
+      count -= chunk;
+    }
+  }
+}
+
+bool ssd1306PagedBegin(uint8_t addr)
+{
+  paged_addr = addr;
+  Wire.begin();
+  Wire.setClock(400000);
+  bool found = pagedCommands(ssd1306_init, sizeof(ssd1306_init), true) == 0;
+  if (found) {
+    pagedSend(nullptr, 0, PAGE_COUNT - 1);
+  }
+  Wire.setClock(100000);
+  return found;
+}
+
+void ssd1306PagedDraw(const PageFrame* frame, uint8_t first, uint8_t last)
+{
+  Wire.setClock(400000);  // same bus speed Adafruit_SSD1306::display() uses
+  pagedSend(frame, first, last);
+  Wire.setClock(100000);
+}
+
+#endif
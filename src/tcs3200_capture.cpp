@@ -0,0 +1,133 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#if defined(ARDUINO) && defined(__AVR_ATmega328P__)
+
+#include <Arduino.h>
+#include <util/atomic.h>
+
+#include "tcs3200_capture.h"
+
+// S2 = D6 = PD6, S3 = D7 = PD7: written from the ISR, digitalWrite() is too slow there
+#define CAPTURE_S2_BIT (1 << PD6)
+#define CAPTURE_S3_BIT (1 << PD7)
+// Timer1 at F_CPU/8: 2 ticks per microsecond, 32.7 ms before the 16 bit counter wraps
+#define CAPTURE_TICKS_PER_MS 2000UL
+// Overflows without any edge before giving up on a filter (surface too dark or no sensor)
+#define CAPTURE_TIMEOUT_OVERFLOWS 2
+
+// S2/S3 levels for red, green, blue
+static const uint8_t capture_filter_bits[3] = {
+  0,                                  // red:   S2 LOW,  S3 LOW
+  CAPTURE_S2_BIT | CAPTURE_S3_BIT,    // green: S2 HIGH, S3 HIGH
+  CAPTURE_S3_BIT                      // blue:  S2 LOW,  S3 HIGH
+};
+
+static uint32_t capture_gate;
+static volatile uint32_t capture_total;
+static volatile uint16_t capture_periods;
+static volatile uint16_t capture_last;
+static volatile uint8_t capture_skip;
+static volatile uint8_t capture_idle_overflows;
+static volatile uint8_t capture_channel;
+static TCS3200Capture capture_pending;     // filled by the ISR channel by channel
+static volatile TCS3200Capture capture_done;
+static volatile uint8_t capture_ready;
+
+static void captureSelectFilter(uint8_t channel)
+{
+  PORTD = (PORTD & ~(CAPTURE_S2_BIT | CAPTURE_S3_BIT)) | capture_filter_bits[channel];
+  capture_channel = channel;
+  capture_total = 0;
+  capture_periods = 0;
+  capture_idle_overflows = 0;
+  // The first edge after the switch only starts the measure
+  capture_skip = 1;
+}
+
+// Called from the ISRs when the gate of the current filter is over
+static void captureNextFilter()
+{
+  uint8_t channel = capture_channel;
+  capture_pending.ticks[channel] = capture_total;
+  capture_pending.periods[channel] = capture_periods;
+  if (channel == 2) {
+    for (uint8_t i = 0; i < 3; i++) {
+      capture_done.ticks[i] = capture_pending.ticks[i];
+      capture_done.periods[i] = capture_pending.periods[i];
+    }
+    capture_ready = 1;
+    channel = 0;
+  } else {
+    channel++;
+  }
+  captureSelectFilter(channel);
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+  uint16_t now = ICR1;
+  capture_idle_overflows = 0;
+  if (capture_skip) {
+    capture_skip = 0;
+    capture_last = now;
+    return;
+  }
+  capture_total += (uint16_t)(now - capture_last);
+  capture_last = now;
+  capture_periods++;
+  if (capture_total >= capture_gate) {
+    captureNextFilter();
+  }
+}
+
+ISR(TIMER1_OVF_vect)
+{
+  if (++capture_idle_overflows >= CAPTURE_TIMEOUT_OVERFLOWS) {
+    captureNextFilter();
+  }
+}
+
+void tcs3200CaptureBegin(uint16_t gateMs)
+{
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    capture_gate = gateMs * CAPTURE_TICKS_PER_MS;
+    capture_ready = 0;
+    captureSelectFilter(0);
+    TCCR1A = 0;
+    // Normal mode, noise canceler, capture on the falling edge, F_CPU/8
+    TCCR1B = (1 << ICNC1) | (1 << CS11);
+    TCNT1 = 0;
+    TIFR1 = (1 << ICF1) | (1 << TOV1);
+    TIMSK1 = (1 << ICIE1) | (1 << TOIE1);
+  }
+}
+
+void tcs3200CaptureEnd()
+{
+  TIMSK1 = 0;
+  TCCR1B = 0;
+}
+
+bool tcs3200CaptureRead(TCS3200Capture* capture)
+{
+  bool ready = false;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (capture_ready) {
+      for (uint8_t i = 0; i < 3; i++) {
+        capture->ticks[i] = capture_done.ticks[i];
+        capture->periods[i] = capture_done.periods[i];
+      }
+      capture_ready = 0;
+      ready = true;
+    }
+  }
+  return ready;
+}
+
+#endif
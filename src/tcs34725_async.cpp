@@ -0,0 +1,109 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#ifdef ARDUINO
+
+#include "tcs34725_async.h"
+
+static uint8_t async_step = 0;
+static unsigned long async_started = 0;
+
+static void asyncApplyStep(Adafruit_TCS34725& tcs)
+{
+  TCS34725Step step = tcs34725RangingStep(async_step);
+  tcs.setIntegrationTime(step.atime);
+  tcs.setGain((tcs34725Gain_t)step.gain);
+}
+
+void tcs34725AsyncBegin(Adafruit_TCS34725& tcs)
+{
+  async_step = 0;
+  asyncApplyStep(tcs);
+#ifdef TCS34725_INT_PIN
+  pinMode(TCS34725_INT_PIN, INPUT_PULLUP);
+  // Persistence 0: interrupt at the end of every integration
+  tcs.write8(TCS34725_PERS, 0);
+  tcs.setInterrupt(true);
+#endif
+  tcs34725AsyncStart(tcs);
+}
+
+void tcs34725AsyncStart(Adafruit_TCS34725& tcs)
+{
+#ifdef TCS34725_INT_PIN
+  tcs.clearInterrupt();
+  uint8_t enable = TCS34725_ENABLE_PON | TCS34725_ENABLE_AIEN;
+#else
+  uint8_t enable = TCS34725_ENABLE_PON;
+#endif
+  // Clearing AEN also clears AVALID, so the next AVALID belongs to this integration
+  tcs.write8(TCS34725_ENABLE, enable);
+  tcs.write8(TCS34725_ENABLE, enable | TCS34725_ENABLE_AEN);
+  async_started = millis();
+}
+
+bool tcs34725AsyncPoll(Adafruit_TCS34725& tcs, TCS34725Raw* raw)
+{
+  // No I2C traffic before the integration can possibly be over
+  if (millis() - async_started < tcs34725RangingIntegrationMs(async_step)) {
+    return false;
+  }
+#ifdef TCS34725_INT_PIN
+  if (digitalRead(TCS34725_INT_PIN) != LOW) {
+    return false;
+  }
+#else
+  if (!(tcs.read8(TCS34725_STATUS) & TCS34725_STATUS_AVALID)) {
+    return false;
+  }
+#endif
+  raw->c = tcs.read16(TCS34725_CDATAL);
+  raw->r = tcs.read16(TCS34725_RDATAL);
+  raw->g = tcs.read16(TCS34725_GDATAL);
+  raw->b = tcs.read16(TCS34725_BDATAL);
+
+  bool usable;
+  uint8_t next = tcs34725RangingNext(async_step, raw, &usable);
+  if (next != async_step) {
+    async_step = next;
+    asyncApplyStep(tcs);
+  }
+  tcs34725AsyncStart(tcs);
+  return usable;
+}
+
+uint8_t tcs34725AsyncStep()
+{
+  return async_step;
+}
+
+uint16_t tcs34725AsyncRemainingMs()
+{
+  unsigned long elapsed = millis() - async_started;
+  uint16_t integration = tcs34725RangingIntegrationMs(async_step);
+  return elapsed >= integration ? 0 : (uint16_t)(integration - elapsed);
+}
+
+void tcs34725AsyncAddSleptMs(uint16_t ms)
+{
+  async_started -= ms;
+}
+
+void tcs34725AsyncSleep(Adafruit_TCS34725& tcs)
+{
+  tcs.write8(TCS34725_ENABLE, 0);
+}
+
+void tcs34725AsyncWake(Adafruit_TCS34725& tcs)
+{
+  tcs.write8(TCS34725_ENABLE, TCS34725_ENABLE_PON);
+  delay(3);
+  tcs34725AsyncStart(tcs);
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "tcs34725_ranging.h"
+
+// Integration cycles (2.4 ms each) and gain of every step, sensitivity always increasing
+static const uint8_t ranging_cycles[TCS34725_RANGING_STEPS] = {1, 1, 1, 1, 10, 10, 21, 43, 64};
+static const uint8_t ranging_gain[TCS34725_RANGING_STEPS]   = {0, 1, 2, 3, 2,  3,  3,  3,  3};
+static const uint8_t gain_factor[4] = {1, 4, 16, 60};
+
+static uint16_t rangingSensitivity(uint8_t step)
+{
+  return (uint16_t)ranging_cycles[step] * gain_factor[ranging_gain[step]];
+}
+
+TCS34725Step tcs34725RangingStep(uint8_t step)
+{
+  TCS34725Step s;
+  s.atime = (uint8_t)(256 - ranging_cycles[step]);
+  s.gain = ranging_gain[step];
+  return s;
+}
+
+uint16_t tcs34725RangingIntegrationMs(uint8_t step)
+{
+  return ((uint16_t)ranging_cycles[step] * 24 + 9) / 10;
+}
+
+uint16_t tcs34725RangingMaxCount(uint8_t step)
+{
+  uint32_t max = (uint32_t)ranging_cycles[step] * 1024;
+  return max > 65535 ? 65535 : (uint16_t)max;
+}
+
+uint8_t tcs34725RangingNext(uint8_t step, const TCS34725Raw* raw, bool* usable)
+{
+  uint32_t max = tcs34725RangingMaxCount(step);
+  uint32_t low = max * TCS34725_RANGING_LOW_PCT / 100;
+  uint32_t high = max * TCS34725_RANGING_HIGH_PCT / 100;
+
+  // Saturated: nothing to estimate from, restart from the fastest step.
+  // Already there: nothing faster exists, better a clipped sample than none
+  if (raw->c >= max) {
+    *usable = step == 0;
+    return 0;
+  }
+  *usable = raw->c >= low || step == TCS34725_RANGING_STEPS - 1;
+  if (raw->c >= low && raw->c <= high) {
+    return step;
+  }
+  if (raw->c == 0) {
+    return TCS34725_RANGING_STEPS - 1;
+  }
+
+  // Fastest step whose expected clear count lands in the band
+  uint16_t sensitivity = rangingSensitivity(step);
+  uint8_t best = raw->c > high ? 0 : step;
+  for (uint8_t i = 0; i < TCS34725_RANGING_STEPS; i++) {
+    uint32_t expected = (uint32_t)raw->c * rangingSensitivity(i) / sensitivity;
+    uint32_t iMax = tcs34725RangingMaxCount(i);
+    if (expected >= iMax * TCS34725_RANGING_LOW_PCT / 100 && expected <= iMax * TCS34725_RANGING_HIGH_PCT / 100) {
+      return i;
+    }
+    // Too dark for every step: keep the most sensitive one that does not saturate
+    if (expected < iMax * TCS34725_RANGING_HIGH_PCT / 100) {
+      best = i;
+    }
+  }
+  return best;
+}
@@ -0,0 +1,123 @@
+/*
+ * Color Blind Helper
+ * Copyright (c) 2025 Giorgio Lazzaretti (lazza13@gmail.com)
+ *
+ * This software is released under the MIT License.
+ * https://opensource.org/licenses/MIT
+ */
+
+#include "telemetry.h"
+
+// Bitwise, no table: 16 bytes per frame are not worth 512 bytes of flash
+uint16_t telemetryCrc16(const uint8_t* data, uint8_t length)
+{
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void putU16(uint8_t* p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t getU16(const uint8_t* p)
+{
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static void putU32(uint8_t* p, uint32_t v)
+{
+  putU16(p, (uint16_t)v);
+  putU16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t getU32(const uint8_t* p)
+{
+  return getU16(p) | ((uint32_t)getU16(p + 2) << 16);
+}
+
+void telemetryEncode(const TelemetrySample* sample, uint8_t* frame)
+{
+  frame[0] = TELEMETRY_SYNC;
+  frame[1] = sample->seq;
+  putU16(frame + 2, sample->raw[0]);
+  putU16(frame + 4, sample->raw[1]);
+  putU16(frame + 6, sample->raw[2]);
+  putU16(frame + 8, sample->clear);
+  frame[10] = sample->color.r;
+  frame[11] = sample->color.g;
+  frame[12] = sample->color.b;
+  frame[13] = (uint8_t)(int8_t)sample->colorClass;
+  putU16(frame + 14, sample->distance > 0xFFFF ? 0xFFFF : (uint16_t)sample->distance);
+  putU16(frame + 16, telemetryCrc16(frame + 1, 15));
+}
+
+bool telemetryDecode(const uint8_t* frame, TelemetrySample* sample)
+{
+  if (frame[0] != TELEMETRY_SYNC || getU16(frame + 16) != telemetryCrc16(frame + 1, 15)) {
+    return false;
+  }
+  sample->seq = frame[1];
+  sample->raw[0] = getU16(frame + 2);
+  sample->raw[1] = getU16(frame + 4);
+  sample->raw[2] = getU16(frame + 6);
+  sample->clear = getU16(frame + 8);
+  sample->color.r = frame[10];
+  sample->color.g = frame[11];
+  sample->color.b = frame[12];
+  sample->colorClass = (ColorClass)(int8_t)frame[13];
+  sample->distance = getU16(frame + 14);
+  return true;
+}
+
+void telemetryEncodeBoot(const BootProfile* profile, uint8_t* frame)
+{
+  frame[0] = TELEMETRY_BOOT_SYNC;
+  for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    putU32(frame + 1 + 4 * i, profile->us[i]);
+  }
+  putU16(frame + TELEMETRY_BOOT_FRAME_SIZE - 2, telemetryCrc16(frame + 1, TELEMETRY_BOOT_FRAME_SIZE - 3));
+}
+
+bool telemetryDecodeBoot(const uint8_t* frame, BootProfile* profile)
+{
+  if (frame[0] != TELEMETRY_BOOT_SYNC
+      || getU16(frame + TELEMETRY_BOOT_FRAME_SIZE - 2) != telemetryCrc16(frame + 1, TELEMETRY_BOOT_FRAME_SIZE - 3)) {
+    return false;
+  }
+  bootProfileReset(profile);
+  for (uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    bootProfileMark(profile, (BootStage)i, getU32(frame + 1 + 4 * i));
+  }
+  return true;
+}
+
+void telemetryEncodeMem(const MemStats* stats, uint8_t* frame)
+{
+  frame[0] = TELEMETRY_MEM_SYNC;
+  putU32(frame + 1, stats->freeRam);
+  putU32(frame + 5, stats->stackFree);
+  putU32(frame + 9, stats->stackPeak);
+  putU32(frame + 13, stats->heapBreak);
+  putU16(frame + TELEMETRY_MEM_FRAME_SIZE - 2, telemetryCrc16(frame + 1, TELEMETRY_MEM_FRAME_SIZE - 3));
+}
+
+bool telemetryDecodeMem(const uint8_t* frame, MemStats* stats)
+{
+  if (frame[0] != TELEMETRY_MEM_SYNC
+      || getU16(frame + TELEMETRY_MEM_FRAME_SIZE - 2) != telemetryCrc16(frame + 1, TELEMETRY_MEM_FRAME_SIZE - 3)) {
+    return false;
+  }
+  stats->freeRam = getU32(frame + 1);
+  stats->stackFree = getU32(frame + 5);
+  stats->stackPeak = getU32(frame + 9);
+  stats->heapBreak = getU32(frame + 13);
+  return true;
+}
@@ -0,0 +1,119 @@
+"""
+Cycle counts of the hot paths on the ATmega328, without a board: builds
+the benchmark firmware (bench/avr/avr_cycles.cpp, env:nanoatmega328_cycles),
+runs it in simavr and prints the counts as JSON.
+
+    python tools/avr_cycles.py > cycles.json
+    python tools/avr_cycles.py --baseline cycles.json --tolerance 2
+
+With --baseline the mean of every measurement is compared with a previous
+run, and the exit status is 1 when one of them got more than --tolerance
+percent slower. --no-build runs an ELF already built (--elf), --port reads
+the same lines from a Nano on a serial port instead (needs pyserial).
+The firmware prints one line per measurement:
+
+    CYCLES <name> <calls> <min> <mean> <max>
+"""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+
+ENV = "nanoatmega328_cycles"
+ELF = ".pio/build/%s/firmware.elf" % ENV
+MCU = "atmega328p"
+F_CPU = 16000000
+LINE = re.compile(r"CYCLES (\S+) (\d+) (\d+) (\d+) (\d+)")
+CALIBRATION = re.compile(r"CALIBRATION base (\d+) overflow (\d+) remainder (\d+)")
+ANSI = re.compile(r"\x1b\[[0-9;]*m")
+
+
+def parse(text):
+    results = {}
+    calibration = None
+    for line in ANSI.sub("", text).splitlines():
+        m = LINE.search(line)
+        if m:
+            calls, low, mean, high = (int(v) for v in m.groups()[1:])
+            results[m.group(1)] = {"calls": calls, "min": low, "mean": mean, "max": high}
+            continue
+        m = CALIBRATION.search(line)
+        if m:
+            calibration = {"base": int(m.group(1)), "overflow": int(m.group(2)), "remainder": int(m.group(3))}
+    return results, calibration
+
+
+def run_simavr(simavr, elf, timeout):
+    # simavr prints the UART lines itself and quits when the firmware
+    # sleeps with interrupts off
+    proc = subprocess.run([simavr, "-m", MCU, "-f", str(F_CPU), elf], stdout=subprocess.PIPE,
+                          stderr=subprocess.STDOUT, universal_newlines=True, timeout=timeout)
+    return proc.stdout
+
+
+def read_port(port, timeout):
+    import serial
+    lines = []
+    with serial.Serial(port, 115200, timeout=timeout) as s:
+        while True:
+            line = s.readline().decode("ascii", "replace")
+            if not line:
+                break
+            lines.append(line)
+            if line.startswith("DONE"):
+                break
+    return "".join(lines)
+
+
+def compare(results, baseline, tolerance):
+    """Lines of the measurements slower than the baseline by more than tolerance percent."""
+    slower = []
+    for name, now in sorted(results.items()):
+        before = baseline.get("results", {}).get(name)
+        if not before or not before["mean"]:
+            continue
+        change = 100.0 * (now["mean"] - before["mean"]) / before["mean"]
+        print("%-28s %9d -> %9d cycles %+6.1f%%" % (name, before["mean"], now["mean"], change), file=sys.stderr)
+        if change > tolerance:
+            slower.append(name)
+    return slower
+
+
+def main():
+    parser = argparse.ArgumentParser(description="AVR cycle counts in simavr")
+    parser.add_argument("--elf", default=ELF)
+    parser.add_argument("--no-build", action="store_true", help="do not run pio run -e %s first" % ENV)
+    parser.add_argument("--simavr", default="simavr")
+    parser.add_argument("--port", help="read a Nano running the benchmark firmware instead of simavr")
+    parser.add_argument("--timeout", type=float, default=120)
+    parser.add_argument("--baseline", help="JSON of a previous run")
+    parser.add_argument("--tolerance", type=float, default=1.0, help="percent slower allowed")
+    args = parser.parse_args()
+
+    if args.port:
+        text = read_port(args.port, args.timeout)
+    else:
+        if not args.no_build:
+            subprocess.run(["pio", "run", "-e", ENV], check=True, stdout=sys.stderr)
+        text = run_simavr(args.simavr, args.elf, args.timeout)
+    results, calibration = parse(text)
+    if not results or "DONE" not in text:
+        sys.stderr.write(text)
+        sys.exit("no complete output from the benchmark firmware")
+    if calibration and calibration["remainder"]:
+        print("warning: uneven overflow interrupt cost, counts may be off by a few cycles", file=sys.stderr)
+
+    report = {"mcu": MCU, "f_cpu": F_CPU, "calibration": calibration, "results": results}
+    json.dump(report, sys.stdout, indent=2, sort_keys=True)
+    print()
+    if args.baseline:
+        with open(args.baseline) as f:
+            slower = compare(results, json.load(f), args.tolerance)
+        if slower:
+            sys.exit("slower than the baseline: " + ", ".join(slower))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,290 @@
+"""
+Learn the reference table of bestMatchRGB() from labelled sensor samples
+and write include/color_calibration.h, used by the firmware with
+COLOR_MATCH_CALIBRATED (include/color_match.h).
+
+    python tools/calibrate.py samples.csv [more.csv ...] [--compare esp32c3]
+    python tools/calibrate.py RED=red.csv GREEN=green.csv UNDEFINED=black.csv
+
+A file is either a CSV with "label,r,g,b" columns (label is a ColorClass
+name: RED or COL_RED) or is given as LABEL=path, and then every row is a
+sample of that class: the output of telemetry_decode.py (r,g,b columns)
+or bare "r,g,b" lines. Samples labelled UNDEFINED are surfaces that must
+not match any class (black, white, background).
+
+For every class the samples are grouped with k-medoids, k = MAX_K, so each
+reference is a real reading. References that do not change the class of
+any sample are then dropped one at a time, smallest group first. The
+threshold of a class accepts THRESHOLD_QUANTILE of its own samples times
+THRESHOLD_MARGIN, and stays below the closest UNDEFINED sample.
+
+One sample out of HOLDOUT_EVERY is kept out of the fit; the report compares
+the new table with the hand-written one of src/color_match.cpp on them.
+"""
+
+import argparse
+import csv
+import os
+import random
+import re
+import sys
+from collections import Counter
+
+MAX_K = 4
+HOLDOUT_EVERY = 5
+THRESHOLD_QUANTILE = 0.99
+THRESHOLD_MARGIN = 2.0      # on the squared distance, about 1.4 on the distance
+THRESHOLD_MIN = 50
+THRESHOLD_MAX = 0xFFFF      # uint16_t in the firmware
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def read_class_values():
+    with open(os.path.join(ROOT, "include", "color_match.h")) as f:
+        header = f.read()
+    body = re.search(r"typedef enum \{(.*?)\} ColorClass;", header, re.S).group(1)
+    values = {}
+    current = -1
+    for name, value in re.findall(r"COL_(\w+)\s*(?:=\s*(-?\d+))?", body):
+        current = int(value) if value else current + 1
+        values[name] = current
+    threshold = int(re.search(r"#define THRESHOLD (\d+)", header).group(1))
+    return values, threshold
+
+
+def read_hand_table(name, classes):
+    with open(os.path.join(ROOT, "src", "color_match.cpp")) as f:
+        source = f.read()
+    block = re.search(r"const ColoReference color_reference_%s\[\] = \{(.*?)\n\};" % name, source, re.S).group(1)
+    entries = re.findall(r"\{\{\s*(\d+),\s*(\d+),\s*(\d+)\s*\},\s*COL_(\w+)\s*\}", block)
+    return [((int(r), int(g), int(b)), classes[c]) for r, g, b, c in entries]
+
+
+def class_of(label, classes):
+    name = label.strip().upper()
+    if name.startswith("COL_"):
+        name = name[4:]
+    if name not in classes:
+        raise ValueError("unknown class %r (one of %s)" % (label, ", ".join(classes)))
+    return classes[name]
+
+
+def channel(text):
+    value = int(text)
+    if value < 0 or value > 255:
+        raise ValueError("channel out of range: %d" % value)
+    return value
+
+
+def read_samples(arg, classes):
+    """(class, (r, g, b)) pairs from one command line argument."""
+    label = None
+    path = arg
+    if "=" in arg and not os.path.exists(arg):
+        label, path = arg.split("=", 1)
+        label = class_of(label, classes)
+    with open(path) as f:
+        rows = list(csv.reader(f))
+    if not rows:
+        return []
+    header = [c.strip().lower() for c in rows[0]]
+    if "r" in header and "g" in header and "b" in header:
+        cols = [header.index(c) for c in ("r", "g", "b")]
+        label_col = header.index("label") if "label" in header else None
+        rows = rows[1:]
+    else:
+        cols = [0, 1, 2]
+        label_col = None
+    if label is None and label_col is None:
+        raise ValueError("%s: no label column, pass it as LABEL=%s" % (path, path))
+    samples = []
+    for row in rows:
+        if len(row) <= max(cols) or not row[cols[0]].strip():
+            continue
+        cls = label if label is not None else class_of(row[label_col], classes)
+        samples.append((cls, tuple(channel(row[c]) for c in cols)))
+    return samples
+
+
+def dist(a, b):
+    return (a[0] - b[0]) ** 2 + (a[1] - b[1]) ** 2 + (a[2] - b[2]) ** 2
+
+
+def classify(refs, thresholds, color):
+    # Same rule as bestMatchRGBTableThresholds()
+    best_dist = 0xFFFFFFFF
+    best = -1
+    for ref, cls in refs:
+        d = dist(color, ref)
+        if d < best_dist and d <= thresholds[cls]:
+            best_dist = d
+            best = cls
+    return best
+
+
+def nearest(refs, color):
+    return min(refs, key=lambda rc: dist(color, rc[0]))[1]
+
+
+def kmedoids(points, k, rng):
+    """Medoids of the weighted points {color: count}, with the size of each group."""
+    colors = sorted(points)
+    if len(colors) <= k:
+        return [(c, points[c]) for c in colors]
+    # k-means++ seeding, then alternate assignment and medoid update
+    medoids = [rng.choice(colors)]
+    while len(medoids) < k:
+        weights = [points[c] * min(dist(c, m) for m in medoids) for c in colors]
+        medoids.append(rng.choices(colors, weights)[0] if sum(weights) else rng.choice(colors))
+    for _ in range(50):
+        groups = [[] for _ in medoids]
+        for c in colors:
+            groups[min(range(len(medoids)), key=lambda i: dist(c, medoids[i]))].append(c)
+        updated = [min(g, key=lambda m: sum(points[c] * dist(c, m) for c in g)) if g else medoids[i]
+                   for i, g in enumerate(groups)]
+        if updated == medoids:
+            break
+        medoids = updated
+    return [(m, sum(points[c] for c in g)) for m, g in zip(medoids, groups) if g]
+
+
+def errors(refs, samples):
+    return sum(count for (cls, color), count in samples.items() if nearest(refs, color) != cls)
+
+
+def prune(refs, sizes, samples):
+    """Drop the references whose removal does not misclassify more samples."""
+    current = errors(refs, samples)
+    changed = True
+    while changed:
+        changed = False
+        for i in sorted(range(len(refs)), key=lambda i: sizes[i]):
+            cls = refs[i][1]
+            if sum(1 for _, c in refs if c == cls) == 1:
+                continue
+            trial = refs[:i] + refs[i + 1:]
+            e = errors(trial, samples)
+            if e <= current:
+                refs, sizes, current = trial, sizes[:i] + sizes[i + 1:], e
+                changed = True
+                break
+    return refs, sizes
+
+
+def learn_thresholds(refs, samples, undefined, names, class_count):
+    thresholds = [0] * class_count
+    for cls in range(class_count):
+        own = [r for r, c in refs if c == cls]
+        if not own:
+            continue
+        dists = sorted(d for (c, color), count in samples.items() if c == cls
+                       for d in [min(dist(color, r) for r in own)] * count)
+        quantile = dists[min(len(dists) - 1, int(THRESHOLD_QUANTILE * len(dists)))]
+        limit = int(quantile * THRESHOLD_MARGIN)
+        # Surfaces that must give "?????" stay out
+        closest = min((min(dist(color, r) for r in own) for color in undefined), default=None)
+        if closest is not None and limit >= closest:
+            limit = closest - 1
+            if limit < quantile:
+                print("warning: %s overlaps the UNDEFINED samples" % names[cls], file=sys.stderr)
+        thresholds[cls] = max(THRESHOLD_MIN, min(THRESHOLD_MAX, limit))
+    return thresholds
+
+
+def accuracy(refs, thresholds, samples):
+    if not samples:
+        return float("nan")
+    good = sum(1 for cls, color in samples if classify(refs, thresholds, color) == cls)
+    return 100.0 * good / len(samples)
+
+
+def write_header(path, refs, sizes, thresholds, names, summary):
+    out = [
+        "#ifndef COLOR_CALIBRATION_H",
+        "#define COLOR_CALIBRATION_H",
+        "",
+        "// Generated by tools/calibrate.py, do not edit.",
+    ]
+    out += ["// " + line for line in summary]
+    out += [
+        "",
+        '#include "color_match.h"',
+        "",
+        "const ColoReference color_reference_calibrated[] = {",
+    ]
+    for i, (((r, g, b), cls), size) in enumerate(zip(refs, sizes)):
+        sep = "," if i < len(refs) - 1 else " "
+        out.append("  {{%3d, %3d, %3d}, COL_%s}%s  // %d samples" % (r, g, b, names[cls], sep, size))
+    out += [
+        "};",
+        "",
+        "// Largest squared distance accepted for each ColorClass",
+        "const uint16_t color_threshold_calibrated[COLOR_CLASS_COUNT] = {",
+    ]
+    for cls, limit in enumerate(thresholds):
+        sep = "," if cls < len(thresholds) - 1 else " "
+        out.append("  %5d%s  // %s" % (limit, sep, names[cls]))
+    out += ["};", "", "#endif"]
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Learn color references from labelled samples")
+    parser.add_argument("inputs", nargs="+", help="label,r,g,b CSV files or LABEL=samples.csv")
+    parser.add_argument("--compare", default="nano", choices=("nano", "esp32c3"),
+                        help="hand-written table to compare with")
+    parser.add_argument("--out", default=os.path.join(ROOT, "include", "color_calibration.h"))
+    args = parser.parse_args()
+
+    classes, threshold = read_class_values()
+    names = {v: k for k, v in classes.items()}
+    class_count = max(classes.values()) + 1
+    samples = []
+    for arg in args.inputs:
+        samples += read_samples(arg, classes)
+
+    # Every HOLDOUT_EVERY-th sample of a class is left out of the fit
+    train, holdout, seen = [], [], Counter()
+    for cls, color in samples:
+        seen[cls] += 1
+        (holdout if seen[cls] % HOLDOUT_EVERY == 0 else train).append((cls, color))
+    undefined = set(color for cls, color in train if cls < 0)
+    weighted = Counter((cls, color) for cls, color in train if cls >= 0)
+    labelled = sorted(set(cls for cls, _ in weighted))
+    if not labelled:
+        sys.exit("no labelled samples")
+
+    refs, sizes = [], []
+    for cls in labelled:
+        points = Counter({color: n for (c, color), n in weighted.items() if c == cls})
+        for medoid, size in kmedoids(points, MAX_K, random.Random(cls)):
+            refs.append((medoid, cls))
+            sizes.append(size)
+    fitted = len(refs)
+    refs, sizes = prune(refs, sizes, weighted)
+    thresholds = learn_thresholds(refs, weighted, undefined, names, class_count)
+
+    hand = read_hand_table(args.compare, classes)
+    flat = [threshold] * class_count
+    summary = [
+        "%d samples (%d held out) from %s" % (len(samples), len(holdout),
+                                              ", ".join(os.path.basename(a) for a in args.inputs)),
+        "%d references (%d before pruning), hand-written %s table: %d" % (len(refs), fitted, args.compare, len(hand)),
+        "holdout accuracy %.1f%%, hand-written table %.1f%%" % (accuracy(refs, thresholds, holdout),
+                                                               accuracy(hand, flat, holdout)),
+        "training accuracy %.1f%%, hand-written table %.1f%%" % (accuracy(refs, thresholds, train),
+                                                                accuracy(hand, flat, train)),
+    ]
+    missing = [names[c] for c in range(class_count) if c not in labelled]
+    if missing:
+        summary.append("no samples for %s, never matched" % ", ".join(missing))
+    write_header(args.out, refs, sizes, thresholds, names, summary)
+    for line in summary:
+        print(line)
+    print("Generated %s" % os.path.relpath(args.out, ROOT))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,160 @@
+"""
+Build, show and upload the per-unit configuration record of the firmware
+(layout in include/device_config.h).
+
+    python tools/device_config.py build config.bin [--table include/color_calibration.h] [--gain 2]
+    python tools/device_config.py show config.bin
+    python tools/device_config.py send /dev/ttyUSB0 config.bin [baud]
+
+"build" takes the reference table and thresholds written by calibrate.py;
+without --table the record keeps the built-in table. "send" uploads the
+record over the serial port (needs pyserial): the firmware checks the CRC,
+stores it in EEPROM/NVS and uses it at once. The host build reads the same
+file (device_config.bin by default).
+
+The TCS3200 white/black values are measured by the device itself: with
+the sensor on a white surface send "W", on a black one send "K". "X" goes
+back to the built-in values. Each command answers OK or ERR.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+import time
+
+MAGIC = 0xCB
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def firmware_constants():
+    with open(os.path.join(ROOT, "include", "device_config.h")) as f:
+        config = f.read()
+    with open(os.path.join(ROOT, "include", "color_match.h")) as f:
+        match = f.read()
+    body = re.search(r"typedef enum \{(.*?)\} ColorClass;", match, re.S).group(1)
+    classes = {}
+    current = -1
+    for name, value in re.findall(r"COL_(\w+)\s*(?:=\s*(-?\d+))?", body):
+        current = int(value) if value else current + 1
+        classes[name] = current
+
+    def define(text, name):
+        return int(re.search(r"#define %s (\d+)" % name, text).group(1))
+
+    return {
+        "version": define(config, "DEVICE_CONFIG_VERSION"),
+        "max_refs": define(config, "DEVICE_CONFIG_MAX_REFERENCES"),
+        "gain": define(config, "DEVICE_CONFIG_DEFAULT_GAIN"),
+        "class_count": define(match, "COLOR_CLASS_COUNT"),
+        "threshold": define(match, "THRESHOLD"),
+        "classes": classes,
+    }
+
+
+def read_table(path, classes):
+    with open(path) as f:
+        text = f.read()
+    block = re.search(r"color_reference_calibrated\[\] = \{(.*?)\n\};", text, re.S).group(1)
+    refs = [((int(r), int(g), int(b)), classes[c])
+            for r, g, b, c in re.findall(r"\{\{\s*(\d+),\s*(\d+),\s*(\d+)\s*\},\s*COL_(\w+)\s*\}", block)]
+    block = re.search(r"color_threshold_calibrated\[COLOR_CLASS_COUNT\] = \{(.*?)\n\};", text, re.S).group(1)
+    thresholds = [int(v) for v in re.findall(r"^\s*(\d+)", block, re.M)]
+    return refs, thresholds
+
+
+def encode(k, white, black, gain, refs, thresholds):
+    if len(refs) > k["max_refs"]:
+        sys.exit("%d references, the record holds %d: calibrate with fewer" % (len(refs), k["max_refs"]))
+    record = bytearray([MAGIC, k["version"]])
+    record += struct.pack("<3h3h", *(list(white) + list(black)))
+    record += bytes([gain, len(refs)])
+    for i in range(k["max_refs"]):
+        (r, g, b), cls = refs[i] if i < len(refs) else ((0, 0, 0), -1)
+        record += struct.pack("<BBBb", r, g, b, cls)
+    record += struct.pack("<%dH" % k["class_count"], *thresholds)
+    record += struct.pack("<H", crc16(record))
+    return bytes(record)
+
+
+def decode(k, record):
+    size = 16 + 4 * k["max_refs"] + 2 * k["class_count"] + 2
+    if len(record) != size:
+        sys.exit("record is %d bytes, expected %d" % (len(record), size))
+    if record[0] != MAGIC or record[1] != k["version"]:
+        sys.exit("not a version %d record" % k["version"])
+    if struct.unpack_from("<H", record, size - 2)[0] != crc16(record[:size - 2]):
+        sys.exit("bad CRC")
+    values = struct.unpack_from("<3h3hBB", record, 2)
+    count = values[7]
+    refs = [struct.unpack_from("<BBBb", record, 16 + 4 * i) for i in range(count)]
+    thresholds = struct.unpack_from("<%dH" % k["class_count"], record, 16 + 4 * k["max_refs"])
+    return values[0:3], values[3:6], values[6], refs, thresholds
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-unit configuration record")
+    sub = parser.add_subparsers(dest="command", required=True)
+    build = sub.add_parser("build")
+    build.add_argument("out")
+    build.add_argument("--table", help="header written by calibrate.py")
+    build.add_argument("--gain", type=int, help="TCS34725 gain, 0 = 1x .. 3 = 60x")
+    build.add_argument("--white", default="0,0,0", help="TCS3200 pulse widths on white, r,g,b")
+    build.add_argument("--black", default="0,0,0", help="TCS3200 pulse widths on black, r,g,b")
+    show = sub.add_parser("show")
+    show.add_argument("record")
+    send = sub.add_parser("send")
+    send.add_argument("port")
+    send.add_argument("record")
+    send.add_argument("baud", nargs="?", type=int, default=9600)
+    args = parser.parse_args()
+    k = firmware_constants()
+
+    if args.command == "build":
+        refs, thresholds = [], [k["threshold"]] * k["class_count"]
+        if args.table:
+            refs, thresholds = read_table(args.table, k["classes"])
+        gain = k["gain"] if args.gain is None else args.gain
+        white = [int(v) for v in args.white.split(",")]
+        black = [int(v) for v in args.black.split(",")]
+        with open(args.out, "wb") as f:
+            f.write(encode(k, white, black, gain, refs, thresholds))
+        print("%s: %d references, gain %d" % (args.out, len(refs), gain))
+    elif args.command == "show":
+        with open(args.record, "rb") as f:
+            white, black, gain, refs, thresholds = decode(k, f.read())
+        names = {v: n for n, v in k["classes"].items()}
+        print("TCS3200 white %s black %s, TCS34725 gain %d" % (list(white), list(black), gain))
+        print("%d references%s" % (len(refs), "" if refs else " (built-in table)"))
+        for r, g, b, cls in refs:
+            print("  %3d %3d %3d  %s" % (r, g, b, names[cls]))
+        print("thresholds: " + ", ".join("%s %d" % (names[i], t) for i, t in enumerate(thresholds)))
+    else:
+        import serial  # pyserial, only needed for the upload
+        with open(args.record, "rb") as f:
+            record = f.read()
+        decode(k, record)
+        with serial.Serial(args.port, args.baud, timeout=3) as s:
+            time.sleep(2)  # opening the port resets the Nano
+            s.write(b"U" + record)
+            # Sample lines may come first, the answer is the line OK or ERR
+            for _ in range(50):
+                line = s.readline().strip()
+                if line in (b"OK", b"ERR"):
+                    print(line.decode())
+                    sys.exit(0 if line == b"OK" else 1)
+        sys.exit("no answer from the device")
+
+
+if __name__ == "__main__":
+    main()
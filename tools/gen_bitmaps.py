@@ -0,0 +1,169 @@
+"""
+Generate include/bitmap_rle.h (40x40, from bitmap/*.bmp) and
+include/small_bitmap_rle.h (20x20, from bitmap/20x20/*.xbm): the icons of
+bitmap.h and small_bitmap.h, run-length compressed for rle_decoder.h.
+
+Asset layout: width, height, then the lengths of the runs of equal pixels
+in row-major order, alternating off/on and starting with off, one nibble
+each (low nibble first). A nibble of 15 adds 15 to the run and continues
+with the next nibble, so a run of 40 is 15, 15, 10.
+
+BMP pixels are on when their luminance (0.299 R + 0.587 G + 0.114 B) is
+above BMP_THRESHOLD, the same test image2cpp used to export bitmap.h.
+Transparent pixels count as black.
+
+Runs as a PlatformIO pre script (extra_scripts) or by hand:
+    python tools/gen_bitmaps.py
+"""
+
+import os
+import re
+import struct
+import sys
+
+BMP_THRESHOLD = 129
+
+# Source file name -> symbol suffix, same names as bitmap.h / small_bitmap.h
+ICONS = (
+    ("sole", "yellow"),
+    ("cuore", "red"),
+    ("cioccolata", "brown"),
+    ("foglia", "green"),
+    ("rosa", "pink"),
+    ("arancia", "orange"),
+    ("formica", "black"),
+    ("maglietta", "azure"),
+    ("nuvola", "white"),
+    ("onde", "blue"),
+    ("principessa", "purple"),
+    ("spada", "gray"),
+)
+
+
+def project_dir():
+    try:
+        Import("env")  # noqa: F821 - defined by PlatformIO/SCons
+        return env["PROJECT_DIR"]  # noqa: F821
+    except NameError:
+        return os.path.dirname(os.path.dirname(os.path.abspath(sys.argv[0])))
+
+
+def read_bmp(path):
+    """Rows of 0/1 pixels of an uncompressed or bitfield 8, 24 or 32 bpp BMP."""
+    with open(path, "rb") as f:
+        data = f.read()
+    offset = struct.unpack_from("<I", data, 10)[0]
+    header_size, width, height, _, bpp, _ = struct.unpack_from("<IiiHHI", data, 14)
+    colors = struct.unpack_from("<I", data, 46)[0] or (1 << bpp if bpp <= 8 else 0)
+    palette = [data[14 + header_size + 4 * i:14 + header_size + 4 * i + 4] for i in range(colors)]
+    if bpp not in (8, 24, 32):
+        raise ValueError("%s: %d bpp not supported" % (path, bpp))
+    stride = (width * bpp + 31) // 32 * 4
+    rows = []
+    for y in range(abs(height)):
+        # Positive height: bottom-up rows
+        line = offset + ((abs(height) - 1 - y) if height > 0 else y) * stride
+        row = []
+        for x in range(width):
+            if bpp == 8:
+                b, g, r = palette[data[line + x]][:3]
+                a = 255
+            elif bpp == 24:
+                b, g, r = data[line + 3 * x:line + 3 * x + 3]
+                a = 255
+            else:
+                b, g, r, a = data[line + 4 * x:line + 4 * x + 4]
+            # Integer luminance x1000, so a gray of exactly 129 stays off
+            row.append(1 if (299 * r + 587 * g + 114 * b) * a > BMP_THRESHOLD * 1000 * 255 else 0)
+        rows.append(row)
+    return rows
+
+
+def read_xbm(path):
+    """Rows of 0/1 pixels of an XBM file (LSB first)."""
+    with open(path) as f:
+        text = f.read()
+    width = int(re.search(r"_width\s+(\d+)", text).group(1))
+    height = int(re.search(r"_height\s+(\d+)", text).group(1))
+    data = [int(v, 16) for v in re.findall(r"0x([0-9a-fA-F]{2})", text.split("{", 1)[1])]
+    row_bytes = (width + 7) // 8
+    return [[(data[y * row_bytes + x // 8] >> (x % 8)) & 1 for x in range(width)] for y in range(height)]
+
+
+def encode(rows):
+    pixels = [p for row in rows for p in row]
+    nibbles = []
+    value = 0
+    i = 0
+    while i < len(pixels):
+        j = i
+        while j < len(pixels) and pixels[j] == value:
+            j += 1
+        run = j - i
+        while run >= 15:
+            nibbles.append(15)
+            run -= 15
+        nibbles.append(run)
+        value ^= 1
+        i = j
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    packed = bytearray([len(rows[0]), len(rows)])
+    for k in range(0, len(nibbles), 2):
+        packed.append(nibbles[k] | (nibbles[k + 1] << 4))
+    return packed
+
+
+def format_array(name, comment, data):
+    lines = ["// %s" % comment, "const unsigned char %s[] PROGMEM = {" % name]
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % v for v in data[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def write_header(root, out_name, guard, pattern, sources, reader):
+    out_path = os.path.join(root, "include", out_name)
+    paths = [p for _, p in sources]
+    if os.path.exists(out_path):
+        newest = max([os.path.getmtime(p) for p in paths] +
+                     [os.path.getmtime(os.path.abspath(__file__)) if "__file__" in globals() else 0])
+        if os.path.getmtime(out_path) >= newest:
+            return
+
+    out = [
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "// Generated by tools/gen_bitmaps.py from %s, do not edit." % pattern,
+        "",
+        '#include "pgm_compat.h"',
+        "",
+    ]
+    raw_total = packed_total = 0
+    for symbol, path in sources:
+        rows = reader(path)
+        packed = encode(rows)
+        raw = (len(rows[0]) + 7) // 8 * len(rows)
+        raw_total += raw
+        packed_total += len(packed)
+        comment = "'%s', %dx%dpx, %d bytes (%d raw)" % (
+            os.path.splitext(os.path.basename(path))[0], len(rows[0]), len(rows), len(packed), raw)
+        out.append(format_array("epd_bitmap_" + symbol, comment, packed))
+        out.append("")
+    out.append("#endif")
+
+    with open(out_path, "w") as f:
+        f.write("\n".join(out) + "\n")
+    print("Generated %s: %d bytes instead of %d" % (os.path.relpath(out_path, root), packed_total, raw_total))
+
+
+def generate(root):
+    bitmap_dir = os.path.join(root, "bitmap")
+    write_header(root, "bitmap_rle.h", "BITMAP_RLE_H", "bitmap/*.bmp",
+                 [(symbol, os.path.join(bitmap_dir, name + ".bmp")) for name, symbol in ICONS], read_bmp)
+    write_header(root, "small_bitmap_rle.h", "SMALL_BITMAP_RLE_H", "bitmap/20x20/*.xbm",
+                 [(symbol, os.path.join(bitmap_dir, "20x20", name + ".xbm")) for name, symbol in ICONS], read_xbm)
+
+
+generate(project_dir())
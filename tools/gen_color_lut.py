@@ -0,0 +1,174 @@
+"""
+Generate include/color_lut.h: a quantized RGB cube with, for every cell,
+the class that bestMatchRGB() gives to all its colors or the short list
+of the only references that can be the nearest one somewhere in it.
+
+One byte per cell: 0 means COL_UNDEFINED, n means ColorClass n-1, and
+LISTS + l (COLOR_LUT_LISTS in color_match.h) sends the color to list l.
+A list holds the table indices, in table order, of the references within
+THRESHOLD of the cell that no other reference beats on the whole cell;
+bestMatchRGBLut() scans just those, so the result is always the one of
+the full scan. The cube is built for both reference tables at 4 bit
+(16x16x16) and 5 bit (32x32x32) per channel; color_match.cpp picks one
+with COLOR_LUT_BITS and the unused ones are dropped by the compiler.
+
+Runs as a PlatformIO pre script (extra_scripts) or by hand:
+    python tools/gen_color_lut.py
+"""
+
+import os
+import re
+import sys
+
+LUT_BITS = (4, 5)
+LISTS = 16      # COLOR_LUT_LISTS in color_match.h
+
+
+def project_dir():
+    try:
+        Import("env")  # noqa: F821 - defined by PlatformIO/SCons
+        return env["PROJECT_DIR"]  # noqa: F821
+    except NameError:
+        return os.path.dirname(os.path.dirname(os.path.abspath(sys.argv[0])))
+
+
+def read_class_values(header):
+    body = re.search(r"typedef enum \{(.*?)\} ColorClass;", header, re.S).group(1)
+    values = {}
+    current = -1
+    for name, value in re.findall(r"(COL_\w+)\s*(?:=\s*(-?\d+))?", body):
+        current = int(value) if value else current + 1
+        values[name] = current
+    return values
+
+
+def read_threshold(header):
+    return int(re.search(r"#define THRESHOLD (\d+)", header).group(1))
+
+
+def read_table(source, name, classes):
+    block = re.search(r"const ColoReference %s\[\] = \{(.*?)\n\};" % name, source, re.S).group(1)
+    entries = re.findall(r"\{\{\s*(\d+),\s*(\d+),\s*(\d+)\s*\},\s*(COL_\w+)\s*\}", block)
+    return [((int(r), int(g), int(b)), classes[c]) for r, g, b, c in entries]
+
+
+def box_distances(ref, low, high):
+    """Smallest and largest squared distance from ref to the box low..high."""
+    near = far = 0
+    for v, lo, hi in zip(ref, low, high):
+        if v < lo:
+            near += (lo - v) ** 2
+        elif v > hi:
+            near += (v - hi) ** 2
+        far += max(v - lo, hi - v) ** 2
+    return near, far
+
+
+def beaten(i, j, table, low, high):
+    """Reference j is nearer than reference i on every color of the box.
+
+    d_i - d_j is linear in the color, so its minimum is at a corner. A tie
+    everywhere goes to the first one in the table, as in the scan.
+    """
+    ri, rj = table[i][0], table[j][0]
+    least = sum(v * v for v in ri) - sum(v * v for v in rj)
+    for a, b, lo, hi in zip(ri, rj, low, high):
+        k = -2 * (a - b)
+        least += min(k * lo, k * hi)
+    return least > 0 or (least == 0 and j < i)
+
+
+def cell_entry(table, threshold, low, high):
+    """(class + 1 or 0, None) when the whole box gets one answer, else (None, candidates)."""
+    distances = [box_distances(ref, low, high) for ref, _ in table]
+    near_enough = [i for i, (near, _) in enumerate(distances) if near <= threshold]
+    candidates = tuple(i for i in near_enough
+                       if not any(beaten(i, j, table, low, high) for j in near_enough if j != i))
+    if not candidates:
+        return 0, None
+    classes = set(table[i][1] for i in candidates)
+    # One class, and one of its references matches on the whole box
+    if len(classes) == 1 and any(distances[i][1] <= threshold for i in candidates):
+        return classes.pop() + 1, None
+    return None, candidates
+
+
+def build_lut(table, threshold, bits):
+    """Cells, start of every list in the list bytes (plus the end), list bytes."""
+    side = 1 << bits
+    shift = 8 - bits
+    cells = bytearray()
+    list_ids = {}
+    for qr in range(side):
+        for qg in range(side):
+            for qb in range(side):
+                low = (qr << shift, qg << shift, qb << shift)
+                high = tuple(v + (1 << shift) - 1 for v in low)
+                value, candidates = cell_entry(table, threshold, low, high)
+                if candidates is not None:
+                    value = LISTS + list_ids.setdefault(candidates, len(list_ids))
+                    if value > 255:
+                        sys.exit("gen_color_lut: more than %d reference lists" % (256 - LISTS))
+                cells.append(value)
+    starts = []
+    lists = bytearray()
+    for candidates in sorted(list_ids, key=list_ids.get):
+        starts.append(len(lists))
+        lists.extend(candidates)
+    starts.append(len(lists))
+    return cells, starts, lists
+
+
+def format_array(name, data, ctype="uint8_t", per_line=16, fmt="0x%02x"):
+    lines = ["const %s %s[] PROGMEM = {" % (ctype, name)]
+    for i in range(0, len(data), per_line):
+        lines.append("  " + ", ".join(fmt % v for v in data[i:i + per_line]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def generate(root):
+    header_path = os.path.join(root, "include", "color_match.h")
+    source_path = os.path.join(root, "src", "color_match.cpp")
+    out_path = os.path.join(root, "include", "color_lut.h")
+
+    if os.path.exists(out_path):
+        newest = max(os.path.getmtime(header_path), os.path.getmtime(source_path),
+                     os.path.getmtime(os.path.abspath(__file__)) if "__file__" in globals() else 0)
+        if os.path.getmtime(out_path) >= newest:
+            return
+
+    with open(header_path) as f:
+        header = f.read()
+    with open(source_path) as f:
+        source = f.read()
+    classes = read_class_values(header)
+    threshold = read_threshold(header)
+
+    out = [
+        "#ifndef COLOR_LUT_H",
+        "#define COLOR_LUT_H",
+        "",
+        "// Generated by tools/gen_color_lut.py from src/color_match.cpp, do not edit.",
+        "",
+        '#include "color_match.h"',
+        "",
+    ]
+    for table_name in ("color_reference_nano", "color_reference_esp32c3"):
+        table = read_table(source, table_name, classes)
+        for bits in LUT_BITS:
+            name = "%s_lut%d" % (table_name, bits)
+            cells, starts, lists = build_lut(table, threshold, bits)
+            out.append(format_array(name + "_cells", cells))
+            out.append(format_array(name + "_starts", starts, "uint16_t", 12, "%d"))
+            out.append(format_array(name + "_lists", lists or [0], per_line=24, fmt="%d"))
+            out.append("const ColorLut %s = {%s_cells, %s_starts, %s_lists, %d};" % (name, name, name, name, bits))
+            out.append("")
+    out.append("#endif")
+
+    with open(out_path, "w") as f:
+        f.write("\n".join(out) + "\n")
+    print("Generated %s" % os.path.relpath(out_path, root))
+
+
+generate(project_dir())
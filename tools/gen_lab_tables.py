@@ -0,0 +1,91 @@
+"""
+Generate include/color_lab_tables.h, the tables used by the fixed-point
+CIELAB conversion in src/color_lab.cpp:
+
+  srgb_to_linear_q16[256]  sRGB gamma expansion, 1.0 = 65535
+  lab_f_q16[257]           CIELAB f(t) sampled at t = i/256, 1.0 = 65535,
+                           linearly interpolated by the converter
+  lab_f_low_q16[257]       same for t < 1/16 at t = i/4096, where the cube
+                           root bends too much for the coarse table
+  LAB_M_*                  linear sRGB to XYZ/(Xn, Yn, Zn) for D65 in Q14,
+                           every row sums to 16384 so white maps to 1.0
+
+    python tools/gen_lab_tables.py
+"""
+
+import os
+
+
+def srgb_to_linear(c):
+    c = c / 255.0
+    return c / 12.92 if c <= 0.04045 else ((c + 0.055) / 1.055) ** 2.4
+
+
+def lab_f(t):
+    delta = 6.0 / 29.0
+    return t ** (1.0 / 3.0) if t > delta ** 3 else t / (3 * delta * delta) + 4.0 / 29.0
+
+
+# sRGB (D65) to XYZ, rows divided by the reference white
+SRGB_TO_XYZ = (
+    ((0.4124564, 0.3575761, 0.1804375), 0.95047),
+    ((0.2126729, 0.7151522, 0.0721750), 1.00000),
+    ((0.0193339, 0.1191920, 0.9503041), 1.08883),
+)
+
+
+def matrix_q14():
+    rows = []
+    for coefficients, white in SRGB_TO_XYZ:
+        row = [int(round(c / white * 16384)) for c in coefficients]
+        # Put the rounding error on the largest coefficient
+        largest = row.index(max(row))
+        row[largest] += 16384 - sum(row)
+        rows.append(row)
+    return rows
+
+
+def q16(v):
+    return min(65535, int(round(v * 65535)))
+
+
+def format_array(name, values):
+    lines = ["const uint16_t %s[] PROGMEM = {" % name]
+    for i in range(0, len(values), 12):
+        lines.append("  " + ", ".join("%5d" % v for v in values[i:i + 12]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    out_path = os.path.join(root, "include", "color_lab_tables.h")
+    out = [
+        "#ifndef COLOR_LAB_TABLES_H",
+        "#define COLOR_LAB_TABLES_H",
+        "",
+        "// Generated by tools/gen_lab_tables.py, do not edit.",
+        "",
+        '#include "pgm_compat.h"',
+        "",
+    ]
+    for axis, row in zip("XYZ", matrix_q14()):
+        for channel, value in zip("RGB", row):
+            out.append("#define LAB_M_%s%s %dUL" % (axis, channel, value))
+    out += [
+        "",
+        format_array("srgb_to_linear_q16", [q16(srgb_to_linear(i)) for i in range(256)]),
+        "",
+        format_array("lab_f_q16", [q16(lab_f(i / 256.0)) for i in range(257)]),
+        "",
+        format_array("lab_f_low_q16", [q16(lab_f(i / 4096.0)) for i in range(257)]),
+        "",
+        "#endif",
+    ]
+    with open(out_path, "w") as f:
+        f.write("\n".join(out) + "\n")
+    print("Generated %s" % os.path.relpath(out_path, root))
+
+
+if __name__ == "__main__":
+    main()
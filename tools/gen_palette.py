@@ -0,0 +1,94 @@
+"""
+Generate a flash-resident palette index for src/palette.cpp from a CSV file
+with a "name,r,g,b" header:
+
+    python tools/gen_palette.py data/palette_css.csv css
+
+writes include/palette_css.h with palette_css_entries[] in k-d tree order,
+the NUL separated names and a `Palette palette_css` descriptor.
+"""
+
+import csv
+import os
+import sys
+
+
+def kd_order(entries, lo, hi, axis):
+    # Same layout paletteSearch() expects: median of [lo, hi) splits on axis
+    if hi - lo <= 1:
+        return
+    entries[lo:hi] = sorted(entries[lo:hi], key=lambda e: e[1][axis])
+    mid = lo + (hi - lo) // 2
+    next_axis = (axis + 1) % 3
+    kd_order(entries, lo, mid, next_axis)
+    kd_order(entries, mid + 1, hi, next_axis)
+
+
+def read_palette(path):
+    entries = []
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            color = (int(row["r"]), int(row["g"]), int(row["b"]))
+            if any(c < 0 or c > 255 for c in color):
+                raise ValueError("%s: color out of range" % row["name"])
+            entries.append((row["name"], color))
+    if not entries or len(entries) > 0x7FFF:
+        raise ValueError("palette must have 1..32767 entries")
+    return entries
+
+
+def c_string(text):
+    return text.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def generate(csv_path, name, out_path):
+    entries = read_palette(csv_path)
+    kd_order(entries, 0, len(entries), 0)
+
+    offsets = {}
+    blob = []
+    offset = 0
+    for entry_name, _ in entries:
+        if entry_name not in offsets:
+            offsets[entry_name] = offset
+            blob.append(entry_name)
+            offset += len(entry_name) + 1
+    if offset > 0xFFFF:
+        raise ValueError("names do not fit in 64 KB")
+
+    guard = "PALETTE_%s_H" % name.upper()
+    out = [
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "// Generated by tools/gen_palette.py from %s, do not edit." % os.path.basename(csv_path),
+        "// %d entries in k-d tree order." % len(entries),
+        "",
+        '#include "palette.h"',
+        "",
+        "const char palette_%s_names[] PROGMEM =" % name,
+    ]
+    for entry_name in blob:
+        out.append('  "%s\\0"' % c_string(entry_name))
+    out[-1] += ";"
+    out.append("")
+    out.append("const PaletteEntry palette_%s_entries[] PROGMEM = {" % name)
+    for entry_name, (r, g, b) in entries:
+        out.append("  {%3d, %3d, %3d, %5d},  // %s" % (r, g, b, offsets[entry_name], entry_name))
+    out.append("};")
+    out.append("")
+    out.append("const Palette palette_%s = {palette_%s_entries, %d, palette_%s_names};" % (name, name, len(entries), name))
+    out.append("")
+    out.append("#endif")
+
+    with open(out_path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit("usage: gen_palette.py palette.csv name")
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    out_path = os.path.join(root, "include", "palette_%s.h" % sys.argv[2])
+    generate(sys.argv[1], sys.argv[2], out_path)
+    print("Generated %s" % os.path.relpath(out_path, root))
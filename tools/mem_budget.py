@@ -0,0 +1,115 @@
+"""
+Flash and RAM used by a firmware, the largest symbols of each, and a check
+against a budget.
+
+Runs after every link as a PlatformIO post script (extra_scripts). The
+budgets are read from the environment in platformio.ini:
+
+    custom_flash_budget = 30720
+    custom_ram_budget = 1536
+
+and the build fails when one is exceeded. It can also be run by hand on
+any ELF file:
+
+    python tools/mem_budget.py .pio/build/nanoatmega328/firmware.elf --nm avr-nm --ram 1536
+
+Flash is text + data (initial values of the RAM variables are copied from
+flash), RAM is data + bss, as printed by avr-size. The stack and the heap
+come on top of the static RAM, so the RAM budget has to leave room for
+them (mem_stats.h measures what they use on the device).
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+TOP = 12
+
+
+def run(tool, args, environ):
+    return subprocess.run([tool] + args, check=True, stdout=subprocess.PIPE,
+                          universal_newlines=True, env=environ).stdout
+
+
+def section_totals(size_tool, elf, environ):
+    # Berkeley format: text data bss dec hex filename
+    line = run(size_tool, ["-B", elf], environ).splitlines()[1].split()
+    text, data, bss = int(line[0]), int(line[1]), int(line[2])
+    return text + data, data + bss
+
+
+def symbols(nm_tool, elf, environ):
+    """(size, kind, name) of every sized symbol, kind "flash", "ram" or "both"."""
+    out = []
+    for line in run(nm_tool, ["-S", "--size-sort", "-C", elf], environ).splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4:
+            continue
+        size, letter, name = int(parts[1], 16), parts[2].lower(), parts[3]
+        if letter in "tw" or letter == "r":
+            kind = "flash"
+        elif letter in "bs":
+            kind = "ram"
+        elif letter in "dg":
+            kind = "both"
+        else:
+            continue
+        out.append((size, kind, name))
+    return out
+
+
+def report(elf, nm_tool, size_tool, flash_budget, ram_budget, environ=None, name=None):
+    """Print the report, return False when a budget is exceeded."""
+    flash, ram = section_totals(size_tool, elf, environ)
+    syms = symbols(nm_tool, elf, environ)
+    print("Memory budget: %s" % (name or elf))
+    ok = True
+    for label, used, budget in (("flash", flash, flash_budget), ("RAM", ram, ram_budget)):
+        if budget:
+            over = used > budget
+            ok &= not over
+            print("  %-5s %7d of %7d bytes (%5.1f%%)%s" % (label, used, budget, 100.0 * used / budget,
+                                                           "  OVER BUDGET" if over else ""))
+        else:
+            print("  %-5s %7d bytes (no budget)" % (label, used))
+    for label, kinds in (("RAM", ("ram", "both")), ("flash", ("flash", "both"))):
+        largest = sorted((s for s in syms if s[1] in kinds), reverse=True)[:TOP]
+        print("  largest %s symbols:" % label)
+        for size, _, symbol in largest:
+            print("    %6d  %s" % (size, symbol))
+    return ok
+
+
+def budget_option(env, option):
+    value = env.GetProjectOption(option, "")
+    return int(value) if value else 0
+
+
+def post_link(target, source, env):
+    # Cross tools next to the compiler: avr-gcc -> avr-nm, riscv32-esp-elf-gcc -> riscv32-esp-elf-nm
+    cc = env.subst("$CC")
+    ok = report(str(target[0]), cc.replace("gcc", "nm"), cc.replace("gcc", "size"),
+                budget_option(env, "custom_flash_budget"), budget_option(env, "custom_ram_budget"),
+                environ=env["ENV"], name=env.subst("$PIOENV"))
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flash/RAM report and budget check of an ELF file")
+    parser.add_argument("elf")
+    parser.add_argument("--nm", default="nm")
+    parser.add_argument("--size", default="size")
+    parser.add_argument("--flash", type=int, default=0, help="flash budget in bytes")
+    parser.add_argument("--ram", type=int, default=0, help="static RAM budget in bytes")
+    args = parser.parse_args()
+    if not os.path.exists(args.elf):
+        sys.exit("%s not found" % args.elf)
+    sys.exit(0 if report(args.elf, args.nm, args.size, args.flash, args.ram) else 1)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    Import("env")  # noqa: F821 - defined by PlatformIO/SCons
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", post_link)  # noqa: F821
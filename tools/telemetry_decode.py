@@ -0,0 +1,124 @@
+"""
+Turn the binary telemetry stream of the firmware (TELEMETRY in
+src/main.cpp, frame layout in include/telemetry.h) into CSV.
+
+    python tools/telemetry_decode.py capture.bin > samples.csv
+    python tools/telemetry_decode.py /dev/ttyUSB0 115200 > samples.csv
+
+The second form reads the serial port directly (needs pyserial) until
+Ctrl+C. Bytes that are not part of a valid frame (boot messages, a frame
+cut in half) are skipped; the "lost" column counts the frames dropped by
+the device before each one, from the gaps in the sequence numbers.
+The boot frame (time to each init stage, boot_profile.h) and the memory
+frame (answer to the command 'M', mem_stats.h) go to stderr.
+"""
+
+import csv
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+FRAME_SIZE = 18
+BOOT_SYNC = 0x5A
+BOOT_STAGES = ("setup", "config", "sensor", "display", "sample", "result")
+BOOT_FRAME_SIZE = 1 + 4 * len(BOOT_STAGES) + 2
+MEM_SYNC = 0xC3
+MEM_FIELDS = ("free", "stack_free", "stack_peak", "heap")
+MEM_FRAME_SIZE = 1 + 4 * len(MEM_FIELDS) + 2
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def class_names():
+    # ColorClass names from the firmware, COL_RED -> RED
+    path = os.path.join(os.path.dirname(os.path.dirname(os.path.abspath(__file__))), "include", "color_match.h")
+    with open(path) as f:
+        body = re.search(r"typedef enum \{(.*?)\} ColorClass;", f.read(), re.S).group(1)
+    names = {}
+    current = -1
+    for name, value in re.findall(r"COL_(\w+)\s*(?:=\s*(-?\d+))?", body):
+        current = int(value) if value else current + 1
+        names[current] = name
+    return names
+
+
+def frames(chunks):
+    """Decoded frames from an iterable of byte strings: ("sample", fields), ("boot", stage times) or ("mem", values)."""
+    buffer = bytearray()
+    for chunk in chunks:
+        buffer += chunk
+        while buffer:
+            if buffer[0] == SYNC:
+                kind, size, layout = "sample", FRAME_SIZE, "<BHHHHBBBbH"
+            elif buffer[0] == BOOT_SYNC:
+                kind, size, layout = "boot", BOOT_FRAME_SIZE, "<%dI" % len(BOOT_STAGES)
+            elif buffer[0] == MEM_SYNC:
+                kind, size, layout = "mem", MEM_FRAME_SIZE, "<%dI" % len(MEM_FIELDS)
+            else:
+                del buffer[0]
+                continue
+            if len(buffer) < size:
+                break
+            frame = bytes(buffer[:size])
+            if struct.unpack_from("<H", frame, size - 2)[0] != crc16(frame[1:size - 2]):
+                # A sync byte inside some other frame or text: resync on the next byte
+                del buffer[0]
+                continue
+            del buffer[:size]
+            yield kind, struct.unpack_from(layout, frame, 1)
+
+
+def read_file(path):
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def read_serial(port, baud):
+    import serial  # pyserial, only needed for live capture
+    with serial.Serial(port, baud, timeout=1) as s:
+        while True:
+            yield s.read(s.in_waiting or 1)
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit("usage: telemetry_decode.py capture.bin | port baud")
+    source = read_serial(sys.argv[1], int(sys.argv[2])) if len(sys.argv) == 3 else read_file(sys.argv[1])
+    names = class_names()
+    out = csv.writer(sys.stdout, lineterminator="\n")
+    out.writerow(["seq", "lost", "raw_r", "raw_g", "raw_b", "clear", "r", "g", "b", "class", "distance"])
+    last_seq = None
+    try:
+        for kind, fields in frames(source):
+            if kind == "boot":
+                print("boot: " + ", ".join("%s %.1f ms" % (name, us / 1000.0)
+                                           for name, us in zip(BOOT_STAGES, fields)), file=sys.stderr)
+                continue
+            if kind == "mem":
+                print("mem: " + ", ".join("%s %d" % (name, value) for name, value in zip(MEM_FIELDS, fields)),
+                      file=sys.stderr)
+                continue
+            seq, raw_r, raw_g, raw_b, clear, r, g, b, cls, distance = fields
+            lost = 0 if last_seq is None else (seq - last_seq - 1) & 0xFF
+            last_seq = seq
+            out.writerow([seq, lost, raw_r, raw_g, raw_b, clear, r, g, b, names.get(cls, cls),
+                          "" if distance == 0xFFFF else distance])
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()